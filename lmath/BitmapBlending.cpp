@@ -0,0 +1,296 @@
+/**
+ * \file BitmapBlending.cpp
+ * \brief
+ *
+ * Apply Blending.h operators to whole RGBA bitmaps (SSE/AVX, multithreaded)
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "BitmapBlending.h"
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lmath/SIMD.h"
+#include "lutils/ThreadPool.h"
+
+using namespace ldr::simd;
+
+namespace {
+
+// Every operator mirrors its scalar counterpart from Blending.h: conditional modes evaluate both branches and select
+template<ldr::eBlendMode Mode>
+struct BlendOp;
+
+#define LDR_BLEND_OP(MODE, EXPR)                                              \
+  template<>                                                                  \
+  struct BlendOp<ldr::eBlendMode_##MODE> {                                    \
+    template<class V>                                                         \
+    static LFORCEINLINE V apply([[maybe_unused]] V b, [[maybe_unused]] V o) { \
+      return EXPR;                                                            \
+    }                                                                         \
+  };
+
+// clang-format off
+LDR_BLEND_OP(Normal,      b)
+LDR_BLEND_OP(Lighten,     select(o > b, o, b))
+LDR_BLEND_OP(Darken,      select(o > b, b, o))
+LDR_BLEND_OP(Multiply,    b * o)
+LDR_BLEND_OP(Average,     (b + o) / V(2.0f))
+LDR_BLEND_OP(Add,         min(b + o, V(1.0f)))
+LDR_BLEND_OP(Subtract,    max(b + o - V(1.0f), V(0.0f)))
+LDR_BLEND_OP(Difference,  abs(b - o))
+LDR_BLEND_OP(Negation,    V(1.0f) - abs(V(1.0f) - b - o))
+LDR_BLEND_OP(Screen,      V(1.0f) - (V(1.0f) - b) * (V(1.0f) - o))
+LDR_BLEND_OP(Exclusion,   b + o - V(2.0f) * b * o)
+LDR_BLEND_OP(Overlay,     select(o < V(0.5f), V(2.0f) * b * o, (V(2.0f) * b - V(1.0f)) * (V(1.0f) - o)))
+LDR_BLEND_OP(SoftLight,   select(o < V(0.5f), (b + V(0.5f)) * o, (b - V(0.5f)) * (V(1.0f) - o)))
+LDR_BLEND_OP(HardLight,   BlendOp<ldr::eBlendMode_Overlay>::apply(o, b))
+LDR_BLEND_OP(ColorDodge,  select(o > V(1.0f - LMATH_EPSILON), o, min(V(1.0f), b / (V(1.0f) - o))))
+LDR_BLEND_OP(ColorBurn,   select(o < V(LMATH_EPSILON), o, max(V(0.0f), V(1.0f) - (V(1.0f) - b) / o)))
+LDR_BLEND_OP(LinearDodge, BlendOp<ldr::eBlendMode_Add>::apply(b, o))
+LDR_BLEND_OP(LinearBurn,  BlendOp<ldr::eBlendMode_Subtract>::apply(b, o))
+LDR_BLEND_OP(LinearLight, select(o < V(0.5f),
+                                 BlendOp<ldr::eBlendMode_LinearBurn>::apply(b, V(2.0f) * o),
+                                 BlendOp<ldr::eBlendMode_LinearDodge>::apply(b, V(2.0f) * (o - V(0.5f)))))
+LDR_BLEND_OP(VividLight,  select(o < V(0.5f),
+                                 BlendOp<ldr::eBlendMode_ColorBurn>::apply(b, V(2.0f) * o),
+                                 BlendOp<ldr::eBlendMode_ColorDodge>::apply(b, V(2.0f) * (o - V(0.5f)))))
+LDR_BLEND_OP(PinLight,    select(o < V(0.5f),
+                                 BlendOp<ldr::eBlendMode_Darken>::apply(b, V(2.0f) * o),
+                                 BlendOp<ldr::eBlendMode_Lighten>::apply(b, V(2.0f) * (o - V(0.5f)))))
+LDR_BLEND_OP(HardMix,     select(BlendOp<ldr::eBlendMode_VividLight>::apply(b, o) < V(0.5f), V(0.0f), V(1.0f)))
+LDR_BLEND_OP(Reflect,     select(o > V(1.0f - LMATH_EPSILON), o, min(V(1.0f), b * b / (V(1.0f) - o))))
+LDR_BLEND_OP(Glow,        BlendOp<ldr::eBlendMode_Reflect>::apply(o, b))
+LDR_BLEND_OP(Phoenix,     min(b, o) - max(b, o) + V(1.0f))
+// clang-format on
+
+#undef LDR_BLEND_OP
+
+// 8-bit fixed-point versions of the operators which do not need a division: values are in 0..255 held in 16-bit lanes,
+// every product is rounded exactly via div255(). The remaining modes fall back to the float path.
+template<ldr::eBlendMode Mode>
+struct BlendOp8;
+
+#define LDR_BLEND_OP8(MODE, EXPR)                                             \
+  template<>                                                                  \
+  struct BlendOp8<ldr::eBlendMode_##MODE> {                                   \
+    template<class V>                                                         \
+    static LFORCEINLINE V apply([[maybe_unused]] V b, [[maybe_unused]] V o) { \
+      return EXPR;                                                            \
+    }                                                                         \
+  };
+
+// clang-format off
+LDR_BLEND_OP8(Normal,      b)
+LDR_BLEND_OP8(Lighten,     max(b, o))
+LDR_BLEND_OP8(Darken,      min(b, o))
+LDR_BLEND_OP8(Multiply,    div255(b * o))
+LDR_BLEND_OP8(Average,     average(b, o))
+LDR_BLEND_OP8(Add,         min(b + o, V(255)))
+LDR_BLEND_OP8(Subtract,    subSat(b + o, V(255)))
+LDR_BLEND_OP8(Difference,  subSat(b, o) | subSat(o, b))
+LDR_BLEND_OP8(Negation,    V(255) - (subSat(V(255), b + o) | subSat(b + o, V(255))))
+LDR_BLEND_OP8(Screen,      V(255) - div255((V(255) - b) * (V(255) - o)))
+LDR_BLEND_OP8(Exclusion,   b + o - div255(b * o) - div255(b * o))
+// the negative part of (2b - 1) * (1 - o) is clamped to 0 here, see kBlendOp8OpaqueOnly
+LDR_BLEND_OP8(Overlay,     select(o < V(128), div255((b + b) * o), div255(subSat(b + b, V(255)) * (V(255) - o))))
+LDR_BLEND_OP8(HardLight,   BlendOp8<ldr::eBlendMode_Overlay>::apply(o, b))
+LDR_BLEND_OP8(LinearDodge, BlendOp8<ldr::eBlendMode_Add>::apply(b, o))
+LDR_BLEND_OP8(LinearBurn,  BlendOp8<ldr::eBlendMode_Subtract>::apply(b, o))
+// both halves reduce to clamp(b + 2o - 1, 0, 1)
+LDR_BLEND_OP8(LinearLight, min(subSat(b + o + o, V(255)), V(255)))
+LDR_BLEND_OP8(PinLight,    select(o < V(128), min(b, o + o), max(b, subSat(o + o, V(255)))))
+LDR_BLEND_OP8(Phoenix,     V(255) - (subSat(b, o) | subSat(o, b)))
+// clang-format on
+
+#undef LDR_BLEND_OP8
+
+template<ldr::eBlendMode Mode>
+constexpr bool kHasBlendOp8 = requires(u16x1 v) { BlendOp8<Mode>::apply(v, v); };
+
+// the float path mixes negative results with base before clamping them, which 8-bit lanes cannot represent
+template<ldr::eBlendMode Mode>
+constexpr bool kBlendOp8OpaqueOnly = Mode == ldr::eBlendMode_Overlay || Mode == ldr::eBlendMode_HardLight;
+
+// channel index of every float in a run of RGBA pixels: used to build the "is alpha" mask for any lane width
+alignas(32) const float kChannels[12] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
+
+template<ldr::eBlendMode Mode, class V>
+LFORCEINLINE void blendLanes(const float* base, const float* overlay, float* out, const float* channels, float opacity) {
+  const V b = V::load(base);
+  const V o = V::load(overlay);
+  const V blended = BlendOp<Mode>::template apply<V>(b, o);
+  const V mixed = blended * V(opacity) + b * V(1.0f - opacity);
+  select(V::load(channels) > V(2.5f), b, mixed).store(out);
+}
+
+// `numFloats` is a multiple of 4 (RGBA)
+template<ldr::eBlendMode Mode>
+void blendRow(const float* base, const float* overlay, float* out, size_t numFloats, float opacity) {
+  size_t i = 0;
+  for (; i + f32xN::kWidth <= numFloats; i += f32xN::kWidth) {
+    blendLanes<Mode, f32xN>(base + i, overlay + i, out + i, kChannels + (i & 3), opacity);
+  }
+  for (; i != numFloats; i++) {
+    blendLanes<Mode, f32x1>(base + i, overlay + i, out + i, kChannels + (i & 3), opacity);
+  }
+}
+
+// channel index of every byte in a run of RGBA pixels
+alignas(32) const uint8_t kChannels8[20] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
+
+template<ldr::eBlendMode Mode, class V>
+LFORCEINLINE void blendLanes8(const uint8_t* base, const uint8_t* overlay, uint8_t* out, const uint8_t* channels, uint16_t opacity) {
+  const V b = V::load(base);
+  const V o = V::load(overlay);
+  const V blended = BlendOp8<Mode>::template apply<V>(b, o);
+  // blended * opacity + b * (1 - opacity) <= 255 * 255 fits into 16 bits
+  const V mixed = div255(blended * V(opacity) + b * V(static_cast<uint16_t>(255 - opacity)));
+  select(V::load(channels) > V(2), b, mixed).store(out);
+}
+
+// `numBytes` is a multiple of 4 (RGBA), `opacity` is in 0..255
+template<ldr::eBlendMode Mode>
+void blendRow8(const uint8_t* base, const uint8_t* overlay, uint8_t* out, size_t numBytes, uint16_t opacity) {
+  size_t i = 0;
+  for (; i + u16xN::kWidth <= numBytes; i += u16xN::kWidth) {
+    blendLanes8<Mode, u16xN>(base + i, overlay + i, out + i, kChannels8 + (i & 3), opacity);
+  }
+  for (; i != numBytes; i++) {
+    blendLanes8<Mode, u16x1>(base + i, overlay + i, out + i, kChannels8 + (i & 3), opacity);
+  }
+}
+
+using BlendRowFunc = void (*)(const float*, const float*, float*, size_t, float);
+using BlendRow8Func = void (*)(const uint8_t*, const uint8_t*, uint8_t*, size_t, uint16_t);
+
+struct BlendRow8 {
+  BlendRow8Func func = nullptr;
+  bool opaqueOnly = false;
+};
+
+template<ldr::eBlendMode Mode>
+constexpr BlendRow8 getBlendRow8() {
+  if constexpr (kHasBlendOp8<Mode>) {
+    return {&blendRow8<Mode>, kBlendOp8OpaqueOnly<Mode>};
+  } else {
+    return {};
+  }
+}
+
+template<size_t... Modes>
+constexpr auto makeBlendRowTable(std::index_sequence<Modes...>) {
+  return std::array<BlendRowFunc, sizeof...(Modes)>{&blendRow<static_cast<ldr::eBlendMode>(Modes)>...};
+}
+
+template<size_t... Modes>
+constexpr auto makeBlendRow8Table(std::index_sequence<Modes...>) {
+  return std::array<BlendRow8, sizeof...(Modes)>{getBlendRow8<static_cast<ldr::eBlendMode>(Modes)>()...};
+}
+
+constexpr auto kBlendRowFuncs = makeBlendRowTable(std::make_index_sequence<ldr::eBlendMode_Count>());
+constexpr auto kBlendRows8 = makeBlendRow8Table(std::make_index_sequence<ldr::eBlendMode_Count>());
+
+// run `func(firstRow, numRows)` over bands of rows
+template<class Func>
+void parallelForRows(size_t width, size_t height, uint32_t numThreads, const Func& func) {
+  // do not spawn threads for less than 64K pixels per thread
+  constexpr size_t kMinPixelsPerThread = 64 * 1024;
+
+  if (!numThreads) {
+    numThreads = std::thread::hardware_concurrency();
+  }
+
+  const size_t maxThreads = (width * height) / kMinPixelsPerThread;
+  const size_t numBands = std::max<size_t>(1, std::min<size_t>({numThreads, maxThreads, height}));
+
+  if (numBands == 1) {
+    func(0, height);
+    return;
+  }
+
+  const size_t rowsPerBand = (height + numBands - 1) / numBands;
+
+  ldr::parallelFor(0, height, [&func](size_t firstRow, size_t endRow) { func(firstRow, endRow - firstRow); }, rowsPerBand);
+}
+
+} // namespace
+
+void ldr::blendBitmaps(eBlendMode mode,
+                       const vec4* base,
+                       const vec4* overlay,
+                       vec4* out,
+                       size_t width,
+                       size_t height,
+                       float opacity,
+                       uint32_t numThreads) {
+  assert(mode < eBlendMode_Count);
+  static_assert(sizeof(vec4) == 4 * sizeof(float));
+
+  const BlendRowFunc blendRowFunc = kBlendRowFuncs[mode];
+
+  parallelForRows(width, height, numThreads, [=](size_t firstRow, size_t numRows) {
+    const size_t offset = firstRow * width;
+    blendRowFunc(&base[offset].x, &overlay[offset].x, &out[offset].x, 4 * numRows * width, opacity);
+  });
+}
+
+void ldr::blendBitmaps(eBlendMode mode,
+                       const vec4b* base,
+                       const vec4b* overlay,
+                       vec4b* out,
+                       size_t width,
+                       size_t height,
+                       float opacity,
+                       uint32_t numThreads) {
+  assert(mode < eBlendMode_Count);
+  static_assert(sizeof(vec4b) == 4 * sizeof(uint8_t));
+
+  const BlendRow8 blendRow8 = kBlendRows8[mode];
+  const uint16_t opacity8 = static_cast<uint16_t>(ldr::clamp(opacity, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+  if (blendRow8.func && (opacity8 == 255 || !blendRow8.opaqueOnly)) {
+    const BlendRow8Func blendRow8Func = blendRow8.func;
+    parallelForRows(width, height, numThreads, [=](size_t firstRow, size_t numRows) {
+      const size_t offset = firstRow * width;
+      blendRow8Func(&base[offset].x, &overlay[offset].x, &out[offset].x, 4 * numRows * width, opacity8);
+    });
+    return;
+  }
+
+  const BlendRowFunc blendRowFunc = kBlendRowFuncs[mode];
+
+  parallelForRows(width, height, numThreads, [=](size_t firstRow, size_t numRows) {
+    // convert to floats in small chunks which stay in L1
+    constexpr size_t kChunk = 256;
+    float b[4 * kChunk];
+    float o[4 * kChunk];
+
+    const uint8_t* src0 = &base[firstRow * width].x;
+    const uint8_t* src1 = &overlay[firstRow * width].x;
+    uint8_t* dst = &out[firstRow * width].x;
+
+    const size_t numFloats = 4 * numRows * width;
+
+    for (size_t i = 0; i < numFloats; i += 4 * kChunk) {
+      const size_t count = std::min(4 * kChunk, numFloats - i);
+      for (size_t j = 0; j != count; j++) {
+        b[j] = static_cast<float>(src0[i + j]) * (1.0f / 255.0f);
+        o[j] = static_cast<float>(src1[i + j]) * (1.0f / 255.0f);
+      }
+      blendRowFunc(b, o, b, count, opacity);
+      for (size_t j = 0; j != count; j++) {
+        dst[i + j] = vec4b::toUNorm8(b[j]);
+      }
+    }
+  });
+}
@@ -0,0 +1,71 @@
+/**
+ * \file BitmapBlending.h
+ * \brief
+ *
+ * Apply Blending.h operators to whole RGBA bitmaps (SSE/AVX, multithreaded)
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include "lmath/Vector.h"
+
+namespace ldr {
+
+enum eBlendMode {
+  eBlendMode_Normal,
+  eBlendMode_Lighten,
+  eBlendMode_Darken,
+  eBlendMode_Multiply,
+  eBlendMode_Average,
+  eBlendMode_Add,
+  eBlendMode_Subtract,
+  eBlendMode_Difference,
+  eBlendMode_Negation,
+  eBlendMode_Screen,
+  eBlendMode_Exclusion,
+  eBlendMode_Overlay,
+  eBlendMode_SoftLight,
+  eBlendMode_HardLight,
+  eBlendMode_ColorDodge,
+  eBlendMode_ColorBurn,
+  eBlendMode_LinearDodge,
+  eBlendMode_LinearBurn,
+  eBlendMode_LinearLight,
+  eBlendMode_VividLight,
+  eBlendMode_PinLight,
+  eBlendMode_HardMix,
+  eBlendMode_Reflect,
+  eBlendMode_Glow,
+  eBlendMode_Phoenix,
+  eBlendMode_Count,
+};
+
+/// Per-channel blend_*(base, overlay) of RGB, mixed with `base` by `opacity`; alpha is taken from `base`.
+/// Bitmaps are `width` x `height` pixels with rows packed tightly, `out` can alias `base` or `overlay`.
+/// Rows are split into up to `numThreads` bands (0 - one per hardware thread, small bitmaps are blended inline) which run
+/// on the default ThreadPool.
+void blendBitmaps(eBlendMode mode,
+                  const vec4* base,
+                  const vec4* overlay,
+                  vec4* out,
+                  size_t width,
+                  size_t height,
+                  float opacity = 1.0f,
+                  uint32_t numThreads = 0);
+/// RGBA8 bitmaps are blended in 8-bit fixed point (exact /255 rounding, `opacity` is quantized to 1/255) by all modes
+/// except SoftLight, ColorDodge, ColorBurn, VividLight, HardMix, Reflect, Glow (and translucent Overlay and HardLight)
+/// which are converted to floats and back.
+void blendBitmaps(eBlendMode mode,
+                  const vec4b* base,
+                  const vec4b* overlay,
+                  vec4b* out,
+                  size_t width,
+                  size_t height,
+                  float opacity = 1.0f,
+                  uint32_t numThreads = 0);
+
+} // namespace ldr
@@ -0,0 +1,186 @@
+/**
+ * \file ColorConversion.cpp
+ * \brief
+ *
+ * Bulk RGBA32F <-> RGBA8 conversions (SSE/AVX), linear <-> sRGB
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "ColorConversion.h"
+
+#include <assert.h>
+#include <cmath>
+#include <string.h>
+
+// clang-format off
+#if defined(LMATH_USE_AVX2)
+#  include <immintrin.h>
+#elif defined(LMATH_USE_SSE4)
+#  include <smmintrin.h>
+#endif
+// clang-format on
+
+namespace {
+
+struct SRGBTables {
+  // sRGB8 -> linear
+  float toLinear[256];
+  // the smallest linear value which is encoded as `k` (the midpoint between k-1 and k), [0] is unused
+  float thresholds[256];
+
+  SRGBTables() {
+    for (int k = 0; k != 256; k++) {
+      toLinear[k] = static_cast<float>(srgbToLinearExact(k / 255.0));
+      thresholds[k] = k ? static_cast<float>(srgbToLinearExact((k - 0.5) / 255.0)) : 0.0f;
+    }
+  }
+
+  static double srgbToLinearExact(double c) {
+    return (c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+  }
+};
+
+const SRGBTables& getSRGBTables() {
+  static const SRGBTables tables;
+  return tables;
+}
+
+LFORCEINLINE uint8_t encodeChannel(const float* thresholds, float linear) {
+  // branch-free binary search: count the thresholds below `linear`
+  uint32_t k = 0;
+  for (uint32_t step = 128; step; step >>= 1) {
+    k += (linear >= thresholds[k + step]) ? step : 0;
+  }
+  return static_cast<uint8_t>(k);
+}
+
+} // namespace
+
+void ldr::convertToRGBA8(std::span<const vec4> src, std::span<vec4b> dst) {
+  assert(dst.size() >= src.size());
+
+  const float* in = &src.data()->x;
+  uint8_t* out = &dst.data()->x;
+
+  const size_t numFloats = 4 * src.size();
+
+  size_t i = 0;
+
+#if defined(LMATH_USE_AVX2)
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(255.0f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  // packs below interleave 128-bit halves
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  auto toInt = [&](const float* p) LFORCEINLINE_LAMBDA {
+    const __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(p), zero), one);
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, scale), half));
+  };
+  for (const size_t end = numFloats & ~size_t(31); i != end; i += 32) {
+    const __m256i v01 = _mm256_packus_epi32(toInt(in + i), toInt(in + i + 8));
+    const __m256i v23 = _mm256_packus_epi32(toInt(in + i + 16), toInt(in + i + 24));
+    const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(v01, v23), order);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+  }
+#elif defined(LMATH_USE_SSE4)
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  auto toInt = [&](const float* p) LFORCEINLINE_LAMBDA {
+    const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), zero), one);
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half));
+  };
+  for (const size_t end = numFloats & ~size_t(15); i != end; i += 16) {
+    const __m128i v01 = _mm_packus_epi32(toInt(in + i), toInt(in + i + 4));
+    const __m128i v23 = _mm_packus_epi32(toInt(in + i + 8), toInt(in + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v01, v23));
+  }
+#endif
+
+  for (; i != numFloats; i++) {
+    out[i] = vec4b::toUNorm8(in[i]);
+  }
+}
+
+void ldr::convertToRGBA32F(std::span<const vec4b> src, std::span<vec4> dst) {
+  assert(dst.size() >= src.size());
+
+  const uint8_t* in = &src.data()->x;
+  float* out = &dst.data()->x;
+
+  const size_t numFloats = 4 * src.size();
+
+  size_t i = 0;
+
+#if defined(LMATH_USE_AVX2)
+  const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+  for (const size_t end = numFloats & ~size_t(7); i != end; i += 8) {
+    const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+#elif defined(LMATH_USE_SSE4)
+  const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+  for (const size_t end = numFloats & ~size_t(3); i != end; i += 4) {
+    int32_t bytes;
+    memcpy(&bytes, in + i, sizeof(bytes));
+    const __m128i v = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+  }
+#endif
+
+  for (; i != numFloats; i++) {
+    out[i] = static_cast<float>(in[i]) * (1.0f / 255.0f);
+  }
+}
+
+void ldr::encodeSRGB8(std::span<const vec4> linear, std::span<vec4b> srgb) {
+  assert(srgb.size() >= linear.size());
+
+  const float* thresholds = getSRGBTables().thresholds;
+
+  size_t i = 0;
+
+#if defined(LMATH_USE_AVX2)
+  // 2 pixels at a time: the binary search is done with gathers, alpha lanes are converted linearly
+  const __m256i alphaMask = _mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  for (const size_t end = linear.size() & ~size_t(1); i != end; i += 2) {
+    const __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(&linear[i].x), zero), one);
+    __m256i k = _mm256_setzero_si256();
+    for (int step = 128; step; step >>= 1) {
+      const __m256i s = _mm256_set1_epi32(step);
+      const __m256 t = _mm256_i32gather_ps(thresholds, _mm256_add_epi32(k, s), 4);
+      k = _mm256_add_epi32(k, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(v, t, _CMP_GE_OQ)), s));
+    }
+    const __m256i a = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+    k = _mm256_blendv_epi8(k, a, alphaMask);
+    const __m128i k16 = _mm_packus_epi32(_mm256_castsi256_si128(k), _mm256_extracti128_si256(k, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&srgb[i].x), _mm_packus_epi16(k16, k16));
+  }
+#endif
+
+  for (; i != linear.size(); i++) {
+    const vec4& v = linear[i];
+    srgb[i] = vec4b(encodeChannel(thresholds, ldr::clamp(v.x, 0.0f, 1.0f)),
+                    encodeChannel(thresholds, ldr::clamp(v.y, 0.0f, 1.0f)),
+                    encodeChannel(thresholds, ldr::clamp(v.z, 0.0f, 1.0f)),
+                    vec4b::toUNorm8(v.w));
+  }
+}
+
+void ldr::decodeSRGB8(std::span<const vec4b> srgb, std::span<vec4> linear) {
+  assert(linear.size() >= srgb.size());
+
+  const float* toLinear = getSRGBTables().toLinear;
+
+  for (size_t i = 0; i != srgb.size(); i++) {
+    const vec4b& c = srgb[i];
+    linear[i] = vec4(toLinear[c.x], toLinear[c.y], toLinear[c.z], static_cast<float>(c.w) * (1.0f / 255.0f));
+  }
+}
@@ -0,0 +1,38 @@
+/**
+ * \file ColorConversion.h
+ * \brief
+ *
+ * Bulk RGBA32F <-> RGBA8 conversions (SSE/AVX), linear <-> sRGB
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <span>
+
+#include "lmath/Vector.h"
+
+namespace ldr {
+
+/// exact sRGB transfer functions (IEC 61966-2-1)
+inline float srgbToLinear(float c) {
+  return (c <= 0.04045f) ? c * (1.0f / 12.92f) : std::pow((c + 0.055f) * (1.0f / 1.055f), 2.4f);
+}
+inline float linearToSrgb(float c) {
+  return (c <= 0.0031308f) ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+/// Clamp to [0..1] and round to the nearest integer, same as vec4b(const vec4&). `dst` should be at least as long as `src`.
+void convertToRGBA8(std::span<const vec4> src, std::span<vec4b> dst);
+/// Divide by 255
+void convertToRGBA32F(std::span<const vec4b> src, std::span<vec4> dst);
+
+/// Encode linear RGB as 8-bit sRGB (exactly rounded), alpha stays linear
+void encodeSRGB8(std::span<const vec4> linear, std::span<vec4b> srgb);
+/// Decode 8-bit sRGB into linear RGB using a lookup table, alpha stays linear
+void decodeSRGB8(std::span<const vec4b> srgb, std::span<vec4> linear);
+
+} // namespace ldr
@@ -0,0 +1,391 @@
+/**
+ * \file GeometryShapesCodec.cpp
+ * \brief
+ *
+ * Compression of GeometryShapes vertex arrays
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "GeometryShapesCodec.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+
+#include "lutils/BitWriter.h"
+#include "lutils/EntropyCoding.h"
+
+using GeometryShapes::Vertex;
+
+namespace {
+
+enum eAttribute {
+  eAttribute_Position = 0,
+  eAttribute_Normal = 1,
+  eAttribute_UV = 2,
+  eAttribute_Count,
+};
+
+// position xyz, octahedral normal, uv
+constexpr uint32_t kNumComponents = 7;
+constexpr eAttribute kComponentAttribute[kNumComponents] = {
+    eAttribute_Position,
+    eAttribute_Position,
+    eAttribute_Position,
+    eAttribute_Normal,
+    eAttribute_Normal,
+    eAttribute_UV,
+    eAttribute_UV,
+};
+
+constexpr uint32_t kMaxBits = 24;
+// a delta is coded as its bit width (Huffman) followed by the bits below the leading one
+constexpr uint32_t kNumCategories = kMaxBits + 1;
+constexpr uint32_t kMaxCodeLength = 12;
+
+struct MeshHeader {
+  static constexpr uint32_t kMagic = 0x48534D4C; // "LMSH"
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint64_t numVertices = 0;
+  uint32_t bits[eAttribute_Count] = {};
+  uint32_t reserved = 0;
+  float posMin[3] = {};
+  float posMax[3] = {};
+  float uvMin[2] = {};
+  float uvMax[2] = {};
+  /// every component has its own bitstream, so the decoder runs kNumComponents independent dependency chains
+  uint64_t streamSizes[kNumComponents] = {};
+};
+
+static_assert(sizeof(MeshHeader) == 128);
+
+// the header is followed by kNumCategories code lengths per attribute and the bitstreams
+constexpr size_t kBitstreamOffset = sizeof(MeshHeader) + eAttribute_Count * kNumCategories;
+
+uint32_t quantize(float v, float minV, float maxV, uint32_t bits) {
+  const double range = double(maxV) - double(minV);
+  if (!(range > 0)) {
+    return 0;
+  }
+  const double maxQ = double((1u << bits) - 1);
+  return static_cast<uint32_t>(std::clamp((double(v) - minV) / range, 0.0, 1.0) * maxQ + 0.5);
+}
+
+// octahedral mapping of a unit vector onto [-1..1]^2
+void encodeOctahedral(GS_VEC3 n, float& x, float& y) {
+  const float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+  if (!(sum > 0)) {
+    x = y = 0;
+    return;
+  }
+  x = n.x / sum;
+  y = n.y / sum;
+  if (n.z < 0) {
+    const float ox = x;
+    x = (1.0f - std::fabs(y)) * (ox >= 0 ? 1.0f : -1.0f);
+    y = (1.0f - std::fabs(ox)) * (y >= 0 ? 1.0f : -1.0f);
+  }
+}
+
+GS_VEC3 decodeOctahedral(float x, float y) {
+  const float z = 1.0f - std::fabs(x) - std::fabs(y);
+  if (z < 0) {
+    const float ox = x;
+    x = (1.0f - std::fabs(y)) * (ox >= 0 ? 1.0f : -1.0f);
+    y = (1.0f - std::fabs(ox)) * (y >= 0 ? 1.0f : -1.0f);
+  }
+  const float invLen = 1.0f / std::sqrt(x * x + y * y + z * z);
+  return GS_VEC3(x * invLen, y * invLen, z * invLen);
+}
+
+// wrap the difference around 2^bits so that every delta fits into `bits` signed bits
+LFORCEINLINE uint32_t encodeDelta(uint32_t value, uint32_t prev, uint32_t bits) {
+  const int32_t delta = static_cast<int32_t>((value - prev) << (32 - bits)) >> (32 - bits);
+  return static_cast<uint32_t>(ldr::zigZagEncode(delta));
+}
+
+// The decoder resolves the bit width with one lookup of kMaxCodeLength bits and takes the bits following the code
+// from the same 32-bit peek, so there are no data-dependent branches for deltas below 2^20
+struct DecodeEntry {
+  uint8_t width;
+  uint8_t codeLength;
+};
+
+void buildDecodeTable(const ldr::HuffmanCodec& codec, DecodeEntry* table) {
+  std::fill(table, table + (1u << kMaxCodeLength), DecodeEntry{0, 0});
+
+  const std::vector<uint8_t>& lengths = codec.getCodeLengths();
+  const std::vector<uint32_t>& codes = codec.getCodes();
+
+  for (uint32_t width = 0; width != lengths.size(); width++) {
+    const uint32_t len = lengths[width];
+    if (!len) {
+      continue;
+    }
+    const uint32_t first = codes[width] << (kMaxCodeLength - len);
+    const uint32_t last = (codes[width] + 1) << (kMaxCodeLength - len);
+    std::fill(table + first, table + last, DecodeEntry{static_cast<uint8_t>(width), static_cast<uint8_t>(len)});
+  }
+}
+
+LFORCEINLINE uint32_t decodeDelta(ldr::BitReader& reader, const DecodeEntry* table) {
+  reader.refill();
+  const uint32_t bits = reader.peekBits(32);
+  const DecodeEntry e = table[bits >> (32 - kMaxCodeLength)];
+  // the leading one of the delta is implied by its width
+  const uint32_t numExtraBits = e.width - (e.width != 0);
+  const uint32_t leading = uint32_t(e.width != 0) << numExtraBits;
+  uint32_t d;
+  if (e.codeLength + numExtraBits <= 32) {
+    // two shifts handle numExtraBits == 0
+    d = leading | (((bits << e.codeLength) >> 1) >> (31 - numExtraBits));
+    reader.consumeBits(e.codeLength + numExtraBits);
+  } else {
+    reader.consumeBits(e.codeLength);
+    d = leading | reader.readBits(numExtraBits);
+  }
+  return static_cast<uint32_t>(ldr::zigZagDecode(d));
+}
+
+bool isValidCodeLengths(const uint8_t* lengths) {
+  uint32_t kraft = 0;
+  for (uint32_t i = 0; i != kNumCategories; i++) {
+    if (lengths[i] > kMaxCodeLength) {
+      return false;
+    }
+    if (lengths[i]) {
+      kraft += 1u << (kMaxCodeLength - lengths[i]);
+    }
+  }
+  return kraft <= (1u << kMaxCodeLength);
+}
+
+} // namespace
+
+std::vector<uint8_t> GeometryShapes::compressVertices(std::span<const Vertex> vertices, const VertexQuantization& quantization) {
+  MeshHeader header;
+  header.numVertices = vertices.size();
+  header.bits[eAttribute_Position] = quantization.positionBits;
+  header.bits[eAttribute_Normal] = quantization.normalBits;
+  header.bits[eAttribute_UV] = quantization.uvBits;
+
+  for (uint32_t b : header.bits) {
+    assert(b >= 1 && b <= kMaxBits);
+    (void)b;
+  }
+
+  if (!vertices.empty()) {
+    const Vertex& v0 = vertices[0];
+    header.posMin[0] = header.posMax[0] = v0.pos.x;
+    header.posMin[1] = header.posMax[1] = v0.pos.y;
+    header.posMin[2] = header.posMax[2] = v0.pos.z;
+    header.uvMin[0] = header.uvMax[0] = v0.uv.x;
+    header.uvMin[1] = header.uvMax[1] = v0.uv.y;
+  }
+
+  for (const Vertex& v : vertices) {
+    const float pos[3] = {v.pos.x, v.pos.y, v.pos.z};
+    const float uv[2] = {v.uv.x, v.uv.y};
+    for (int i = 0; i != 3; i++) {
+      header.posMin[i] = std::min(header.posMin[i], pos[i]);
+      header.posMax[i] = std::max(header.posMax[i], pos[i]);
+    }
+    for (int i = 0; i != 2; i++) {
+      header.uvMin[i] = std::min(header.uvMin[i], uv[i]);
+      header.uvMax[i] = std::max(header.uvMax[i], uv[i]);
+    }
+  }
+
+  // pass 1: quantized deltas and their histograms
+  std::vector<uint32_t> deltas(vertices.size() * kNumComponents);
+  uint32_t histograms[eAttribute_Count][kNumCategories] = {};
+
+  uint32_t prev[kNumComponents] = {};
+
+  for (size_t i = 0; i != vertices.size(); i++) {
+    const Vertex& v = vertices[i];
+
+    float nx, ny;
+    encodeOctahedral(v.normal, nx, ny);
+
+    const uint32_t normalBits = header.bits[eAttribute_Normal];
+    const uint32_t q[kNumComponents] = {
+        quantize(v.pos.x, header.posMin[0], header.posMax[0], header.bits[eAttribute_Position]),
+        quantize(v.pos.y, header.posMin[1], header.posMax[1], header.bits[eAttribute_Position]),
+        quantize(v.pos.z, header.posMin[2], header.posMax[2], header.bits[eAttribute_Position]),
+        quantize(nx, -1.0f, 1.0f, normalBits),
+        quantize(ny, -1.0f, 1.0f, normalBits),
+        quantize(v.uv.x, header.uvMin[0], header.uvMax[0], header.bits[eAttribute_UV]),
+        quantize(v.uv.y, header.uvMin[1], header.uvMax[1], header.bits[eAttribute_UV]),
+    };
+
+    for (uint32_t c = 0; c != kNumComponents; c++) {
+      const eAttribute attr = kComponentAttribute[c];
+      const uint32_t d = encodeDelta(q[c], prev[c], header.bits[attr]);
+      deltas[i * kNumComponents + c] = d;
+      histograms[attr][std::bit_width(d)]++;
+      prev[c] = q[c];
+    }
+  }
+
+  const ldr::HuffmanCodec codecs[eAttribute_Count] = {
+      ldr::HuffmanCodec(histograms[eAttribute_Position], kMaxCodeLength),
+      ldr::HuffmanCodec(histograms[eAttribute_Normal], kMaxCodeLength),
+      ldr::HuffmanCodec(histograms[eAttribute_UV], kMaxCodeLength),
+  };
+
+  // pass 2: the bitstreams
+  std::vector<uint8_t> streams[kNumComponents];
+
+  for (uint32_t c = 0; c != kNumComponents; c++) {
+    const ldr::HuffmanCodec& codec = codecs[kComponentAttribute[c]];
+
+    ldr::BitWriterVector writer(streams[c]);
+
+    for (size_t i = c; i < deltas.size(); i += kNumComponents) {
+      const uint32_t d = deltas[i];
+      const uint32_t width = std::bit_width(d);
+      codec.encode(writer, width);
+      // the leading one is implied by the width
+      if (width > 1) {
+        writer.writeBits(d, width - 1);
+      }
+    }
+
+    writer.finish();
+
+    header.streamSizes[c] = streams[c].size();
+  }
+
+  std::vector<uint8_t> out(kBitstreamOffset);
+
+  memcpy(out.data(), &header, sizeof(header));
+
+  for (uint32_t a = 0; a != eAttribute_Count; a++) {
+    const std::vector<uint8_t>& lengths = codecs[a].getCodeLengths();
+    std::copy(lengths.begin(), lengths.end(), out.begin() + sizeof(header) + a * kNumCategories);
+  }
+
+  for (const std::vector<uint8_t>& stream : streams) {
+    out.insert(out.end(), stream.begin(), stream.end());
+  }
+
+  return out;
+}
+
+bool GeometryShapes::decompressVertices(std::span<const uint8_t> data, std::vector<Vertex>& vertices) {
+  MeshHeader header;
+
+  if (data.size() < kBitstreamOffset) {
+    printf("Compressed mesh is truncated\n");
+    return false;
+  }
+
+  memcpy(&header, data.data(), sizeof(header));
+
+  if (header.magic != MeshHeader::kMagic || header.version != MeshHeader::kVersion) {
+    printf("Not a compressed mesh\n");
+    return false;
+  }
+
+  for (uint32_t b : header.bits) {
+    if (b < 1 || b > kMaxBits) {
+      printf("Invalid compressed mesh quantization\n");
+      return false;
+    }
+  }
+
+  const uint8_t* codeLengths = data.data() + sizeof(header);
+
+  for (uint32_t a = 0; a != eAttribute_Count; a++) {
+    if (!isValidCodeLengths(codeLengths + a * kNumCategories)) {
+      printf("Invalid compressed mesh code lengths\n");
+      return false;
+    }
+  }
+
+  const uint8_t* streams[kNumComponents];
+
+  size_t streamOffset = kBitstreamOffset;
+
+  for (uint32_t c = 0; c != kNumComponents; c++) {
+    // every vertex takes at least one bit per component: reject bogus sizes before allocating
+    if (header.streamSizes[c] > data.size() - streamOffset || header.numVertices > header.streamSizes[c] * 8) {
+      printf("Compressed mesh is truncated\n");
+      return false;
+    }
+    streams[c] = data.data() + streamOffset;
+    streamOffset += static_cast<size_t>(header.streamSizes[c]);
+  }
+
+  DecodeEntry decodeTables[eAttribute_Count][1u << kMaxCodeLength];
+
+  for (uint32_t a = 0; a != eAttribute_Count; a++) {
+    buildDecodeTable(ldr::HuffmanCodec::fromCodeLengths({codeLengths + a * kNumCategories, kNumCategories}), decodeTables[a]);
+  }
+
+  // dequantization: min + q * scale
+  float offset[kNumComponents];
+  float scale[kNumComponents];
+  uint32_t mask[kNumComponents];
+
+  for (uint32_t c = 0; c != kNumComponents; c++) {
+    const uint32_t bits = header.bits[kComponentAttribute[c]];
+    const float maxQ = float((1u << bits) - 1);
+    float minV = -1.0f;
+    float maxV = 1.0f;
+    if (c < 3) {
+      minV = header.posMin[c];
+      maxV = header.posMax[c];
+    } else if (c >= 5) {
+      minV = header.uvMin[c - 5];
+      maxV = header.uvMax[c - 5];
+    }
+    offset[c] = minV;
+    scale[c] = (maxV - minV) / maxQ;
+    mask[c] = (1u << bits) - 1;
+  }
+
+  vertices.resize(static_cast<size_t>(header.numVertices));
+
+  ldr::BitReader readers[kNumComponents] = {
+      {streams[0], header.streamSizes[0]},
+      {streams[1], header.streamSizes[1]},
+      {streams[2], header.streamSizes[2]},
+      {streams[3], header.streamSizes[3]},
+      {streams[4], header.streamSizes[4]},
+      {streams[5], header.streamSizes[5]},
+      {streams[6], header.streamSizes[6]},
+  };
+
+  uint32_t q[kNumComponents] = {};
+
+  for (Vertex& v : vertices) {
+    for (uint32_t c = 0; c != kNumComponents; c++) {
+      q[c] = (q[c] + decodeDelta(readers[c], decodeTables[kComponentAttribute[c]])) & mask[c];
+    }
+    v.pos = GS_VEC3(offset[0] + float(q[0]) * scale[0], offset[1] + float(q[1]) * scale[1], offset[2] + float(q[2]) * scale[2]);
+    v.normal = decodeOctahedral(offset[3] + float(q[3]) * scale[3], offset[4] + float(q[4]) * scale[4]);
+    v.uv = GS_VEC2(offset[5] + float(q[5]) * scale[5], offset[6] + float(q[6]) * scale[6]);
+  }
+
+  for (const ldr::BitReader& reader : readers) {
+    if (reader.isOverrun()) {
+      printf("Compressed mesh is truncated\n");
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,175 @@
+/**
+ * \file LowDiscrepancy.h
+ * \brief
+ *
+ * Low-discrepancy sequences (Halton, Sobol with Owen scrambling, R2/R3)
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include "lmath/Math.h"
+#include "lmath/Random.h"
+
+namespace ldr {
+
+[[nodiscard]] constexpr uint32_t reverseBits(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+  x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+/// Owen scrambling as a hash (Burley 2020, "Practical Hash-based Owen Scrambling")
+[[nodiscard]] constexpr uint32_t nestedUniformScramble(uint32_t x, uint32_t seed) {
+  x = reverseBits(x);
+  x ^= x * 0x3d20adeau;
+  x += seed;
+  x *= (seed >> 16) | 1u;
+  x ^= x * 0x05526c56u;
+  x ^= x * 0x53a22864u;
+  return reverseBits(x);
+}
+
+namespace detail {
+
+struct SobolDirections {
+  uint32_t v[3][32] = {};
+  // primitive polynomial of degree `s` with coefficients `a` and initial direction numbers `m`
+  constexpr void init(uint32_t dim, uint32_t s, uint32_t a, const uint32_t* m) {
+    for (uint32_t i = 0; i != 32; i++) {
+      if (i < s) {
+        v[dim][i] = m[i] << (31 - i);
+        continue;
+      }
+      v[dim][i] = v[dim][i - s] ^ (v[dim][i - s] >> s);
+      for (uint32_t k = 1; k != s; k++) {
+        if ((a >> (s - 1 - k)) & 1)
+          v[dim][i] ^= v[dim][i - k];
+      }
+    }
+  }
+  constexpr SobolDirections() {
+    for (uint32_t i = 0; i != 32; i++) {
+      v[0][i] = 1u << (31 - i);
+    }
+    const uint32_t m1[] = {1};
+    const uint32_t m2[] = {1, 3};
+    init(1, 1, 0, m1);
+    init(2, 2, 1, m2);
+  }
+  constexpr const uint32_t* operator[](uint32_t dim) const {
+    return v[dim];
+  }
+};
+
+inline constexpr SobolDirections kSobolDirections = SobolDirections();
+
+} // namespace detail
+
+} // namespace ldr
+
+/// Shared API: sequences provide getVector2(index) and getVector3(index)
+template<typename Derived>
+struct LLowDiscrepancySequence {
+  uint32_t index_ = 0;
+
+  RND_VEC2 nextVector2() {
+    return self().getVector2(index_++);
+  }
+  RND_VEC3 nextVector3() {
+    return self().getVector3(index_++);
+  }
+  void fillVector2(RND_VEC2* out, size_t n) {
+    for (size_t i = 0; i != n; i++) {
+      out[i] = self().getVector2(index_++);
+    }
+  }
+  void fillVector3(RND_VEC3* out, size_t n) {
+    for (size_t i = 0; i != n; i++) {
+      out[i] = self().getVector3(index_++);
+    }
+  }
+
+ private:
+  const Derived& self() const {
+    return static_cast<const Derived&>(*this);
+  }
+};
+
+/// Halton sequence in bases 2, 3, 5
+struct LHalton : LLowDiscrepancySequence<LHalton> {
+  template<uint32_t Base>
+  static float radicalInverse(uint32_t index) {
+    if constexpr (Base == 2) {
+      return ldr::uint32ToUnitFloat(ldr::reverseBits(index));
+    } else {
+      // accumulate the reversed digits as an integer to avoid rounding errors
+      constexpr double kInvBase = 1.0 / Base;
+      uint64_t reversed = 0;
+      double invBaseN = 1.0;
+      while (index) {
+        const uint32_t next = index / Base;
+        reversed = reversed * Base + (index - next * Base);
+        invBaseN *= kInvBase;
+        index = next;
+      }
+      const float f = static_cast<float>(static_cast<double>(reversed) * invBaseN);
+      return f < 1.0f ? f : 0.99999994f;
+    }
+  }
+  RND_VEC2 getVector2(uint32_t index) const {
+    return RND_VEC2(radicalInverse<2>(index), radicalInverse<3>(index));
+  }
+  RND_VEC3 getVector3(uint32_t index) const {
+    return RND_VEC3(radicalInverse<2>(index), radicalInverse<3>(index), radicalInverse<5>(index));
+  }
+};
+
+/// Sobol sequence (3 dimensions, Joe-Kuo direction numbers) with optional Owen scrambling: `seed_ == 0` disables it
+struct LSobol : LLowDiscrepancySequence<LSobol> {
+  uint32_t seed_ = 0;
+
+  LSobol() = default;
+  explicit LSobol(uint32_t seed) : seed_(seed) {}
+
+  static uint32_t sample(uint32_t index, uint32_t dim) {
+    uint32_t x = 0;
+    for (uint32_t bit = 0; index; index >>= 1, bit++) {
+      if (index & 1)
+        x ^= ldr::detail::kSobolDirections[dim][bit];
+    }
+    return x;
+  }
+  uint32_t sampleScrambled(uint32_t index, uint32_t dim) const {
+    const uint32_t x = sample(index, dim);
+    return seed_ ? ldr::nestedUniformScramble(x, ldr::hash_uint32(seed_ + dim)) : x;
+  }
+  RND_VEC2 getVector2(uint32_t index) const {
+    return RND_VEC2(ldr::uint32ToUnitFloat(sampleScrambled(index, 0)), ldr::uint32ToUnitFloat(sampleScrambled(index, 1)));
+  }
+  RND_VEC3 getVector3(uint32_t index) const {
+    return RND_VEC3(ldr::uint32ToUnitFloat(sampleScrambled(index, 0)),
+                    ldr::uint32ToUnitFloat(sampleScrambled(index, 1)),
+                    ldr::uint32ToUnitFloat(sampleScrambled(index, 2)));
+  }
+};
+
+/// Roberts' R2/R3 additive recurrence sequences based on the generalized golden ratio, computed in 32-bit fixed point
+struct LRSequence : LLowDiscrepancySequence<LRSequence> {
+  RND_VEC2 getVector2(uint32_t index) const {
+    // 2^32 / g, 2^32 / g^2 where g = 1.32471795724474602596 (plastic number)
+    return RND_VEC2(ldr::uint32ToUnitFloat(0x80000000u + index * 3242174889u),
+                    ldr::uint32ToUnitFloat(0x80000000u + index * 2447445414u));
+  }
+  RND_VEC3 getVector3(uint32_t index) const {
+    // 2^32 / g, 2^32 / g^2, 2^32 / g^3 where g = 1.22074408460575947536
+    return RND_VEC3(ldr::uint32ToUnitFloat(0x80000000u + index * 3518319155u),
+                    ldr::uint32ToUnitFloat(0x80000000u + index * 2882110345u),
+                    ldr::uint32ToUnitFloat(0x80000000u + index * 2360945575u));
+  }
+};
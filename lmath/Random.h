@@ -12,9 +12,20 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
+#include "lutils/Macros.h"
+
+// clang-format off
+#if defined(LMATH_USE_AVX2)
+#  include <immintrin.h>
+#elif defined(LMATH_USE_SSE4)
+#  include <smmintrin.h>
+#endif
+// clang-format on
+
 #if (!defined(RND_VEC2) || !defined(RND_VEC3) || !defined(RND_VEC4)) && __has_include(<glm/glm.hpp>)
 #include <glm/glm.hpp>
 using RND_VEC2 = glm::vec2;
@@ -27,22 +38,27 @@ using RND_VEC3 = ldr::vec3;
 using RND_VEC4 = ldr::vec4;
 #endif
 
-/// a very fast PRNG without extra dependencies
-struct LRandom {
-  uint32_t seed_ = 7;
+namespace ldr {
 
-  // based on https://iquilezles.org/articles/sfrand/
-  float random() {
-    seed_ *= 16807;
-    const uint32_t a = (seed_ & 0x007fffff) | 0x40000000;
-    // remap to 0..1
-    float f;
-    memcpy(&f, &a, sizeof(f));
-    return 0.5f * (f - 2.0f);
+// the upper 24 bits -> [0..1)
+[[nodiscard]] inline float uint32ToUnitFloat(uint32_t x) {
+  return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+} // namespace ldr
+
+/// Distributions shared by all generators. `Derived` provides `float random()` in [0..1) and can provide
+/// a faster `fill(float* out, size_t n)`
+template<typename Derived>
+struct LRandomDistributions {
+  void fill(float* out, size_t n) {
+    for (size_t i = 0; i != n; i++) {
+      out[i] = self().random();
+    }
   }
 
   float randomInRange(float rMin, float rMax) {
-    return rMin + random() * (rMax - rMin);
+    return rMin + self().random() * (rMax - rMin);
   }
   RND_VEC2 randomVector2InRange(const RND_VEC2& rMin, const RND_VEC2& rMax) {
     return RND_VEC2(randomInRange(rMin.x, rMax.x), randomInRange(rMin.y, rMax.y));
@@ -76,4 +92,155 @@ struct LRandom {
     }
     return RND_VEC3(x, y, z);
   }
+  // rejection-free sampling: every function below consumes a fixed amount of random numbers (see RandomSampling.h for batches)
+  RND_VEC3 randomVector3OnUnitSphereSurfaceRejectionFree() {
+    const float z = 1.0f - 2.0f * self().random();
+    const float r = sqrtf(fmaxf(0.0f, 1.0f - z * z));
+    const float phi = 6.28318530717958647692f * self().random();
+    return RND_VEC3(r * cosf(phi), r * sinf(phi), z);
+  }
+  RND_VEC3 randomVector3InsideUnitSphereRejectionFree() {
+    const RND_VEC3 dir = randomVector3OnUnitSphereSurfaceRejectionFree();
+    return dir * cbrtf(self().random());
+  }
+  /// hemisphere around +Z
+  RND_VEC3 randomVector3OnUnitHemisphere() {
+    const float z = self().random();
+    const float r = sqrtf(fmaxf(0.0f, 1.0f - z * z));
+    const float phi = 6.28318530717958647692f * self().random();
+    return RND_VEC3(r * cosf(phi), r * sinf(phi), z);
+  }
+  /// hemisphere around +Z, pdf = cos(theta)/pi (Malley's method)
+  RND_VEC3 randomVector3CosineWeightedHemisphere() {
+    const RND_VEC2 d = randomVector2InsideUnitDisk();
+    return RND_VEC3(d.x, d.y, sqrtf(fmaxf(0.0f, 1.0f - d.x * d.x - d.y * d.y)));
+  }
+  RND_VEC2 randomVector2InsideUnitDisk() {
+    const float r = sqrtf(self().random());
+    const float phi = 6.28318530717958647692f * self().random();
+    return RND_VEC2(r * cosf(phi), r * sinf(phi));
+  }
+  /// uniformly distributed point inside the triangle (a, b, c)
+  RND_VEC3 randomVector3InsideTriangle(const RND_VEC3& a, const RND_VEC3& b, const RND_VEC3& c) {
+    const float su = sqrtf(self().random());
+    const float v = self().random();
+    return a * (1.0f - su) + b * (su * (1.0f - v)) + c * (su * v);
+  }
+
+  void fillInRange(float* out, size_t n, float rMin, float rMax) {
+    self().fill(out, n);
+    const float range = rMax - rMin;
+    for (size_t i = 0; i != n; i++) {
+      out[i] = rMin + out[i] * range;
+    }
+  }
+  void fillVector2InRange(RND_VEC2* out, size_t n, const RND_VEC2& rMin, const RND_VEC2& rMax) {
+    fillComponents<2>(out, n, [&rMin, &rMax](const float* r) {
+      return RND_VEC2(rMin.x + r[0] * (rMax.x - rMin.x), rMin.y + r[1] * (rMax.y - rMin.y));
+    });
+  }
+  void fillVector3InRange(RND_VEC3* out, size_t n, const RND_VEC3& rMin, const RND_VEC3& rMax) {
+    fillComponents<3>(out, n, [&rMin, &rMax](const float* r) {
+      return RND_VEC3(rMin.x + r[0] * (rMax.x - rMin.x), rMin.y + r[1] * (rMax.y - rMin.y), rMin.z + r[2] * (rMax.z - rMin.z));
+    });
+  }
+  void fillVector4InRange(RND_VEC4* out, size_t n, const RND_VEC4& rMin, const RND_VEC4& rMax) {
+    fillComponents<4>(out, n, [&rMin, &rMax](const float* r) {
+      return RND_VEC4(rMin.x + r[0] * (rMax.x - rMin.x),
+                      rMin.y + r[1] * (rMax.y - rMin.y),
+                      rMin.z + r[2] * (rMax.z - rMin.z),
+                      rMin.w + r[3] * (rMax.w - rMin.w));
+    });
+  }
+
+ private:
+  Derived& self() {
+    return static_cast<Derived&>(*this);
+  }
+  // generate random numbers in chunks and convert every `N` consecutive floats into an output value
+  template<size_t N, typename Vec, typename Func>
+  void fillComponents(Vec* out, size_t n, const Func& func) {
+    constexpr size_t kChunk = 256;
+    float r[kChunk * N];
+    for (size_t i = 0; i < n; i += kChunk) {
+      const size_t count = (n - i < kChunk) ? n - i : kChunk;
+      self().fill(r, count * N);
+      for (size_t j = 0; j != count; j++) {
+        out[i + j] = func(r + j * N);
+      }
+    }
+  }
+};
+
+/// a very fast PRNG without extra dependencies
+struct LRandom : LRandomDistributions<LRandom> {
+  uint32_t seed_ = 7;
+
+  LRandom() = default;
+  LRandom(uint32_t seed) : seed_(seed) {}
+
+  // based on https://iquilezles.org/articles/sfrand/
+  float random() {
+    seed_ *= 16807;
+    const uint32_t a = (seed_ & 0x007fffff) | 0x40000000;
+    // remap to 0..1
+    float f;
+    memcpy(&f, &a, sizeof(f));
+    return 0.5f * (f - 2.0f);
+  }
+
+  /// Same as calling random() `n` times, but the LCG is split into 8 (AVX2) or 4 (SSE) interleaved streams:
+  /// lane k produces elements k, k+W, k+2W... of the scalar sequence, so there is no serial dependency chain.
+  void fill(float* out, size_t n) {
+    size_t i = 0;
+#if defined(LMATH_USE_AVX2)
+    if (n >= 8) {
+      uint32_t lanes[8];
+      for (uint32_t k = 0, s = seed_; k != 8; k++) {
+        lanes[k] = s *= 16807;
+      }
+      __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+      const __m256i step = _mm256_set1_epi32(static_cast<int>(pow16807(8)));
+      const __m256i mantissa = _mm256_set1_epi32(0x007fffff);
+      const __m256i exponent = _mm256_set1_epi32(0x40000000);
+      for (const size_t end = n & ~size_t(7); i != end; i += 8) {
+        const __m256 f = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(state, mantissa), exponent));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_set1_ps(0.5f), _mm256_sub_ps(f, _mm256_set1_ps(2.0f))));
+        state = _mm256_mullo_epi32(state, step);
+      }
+      seed_ *= pow16807(i);
+    }
+#elif defined(LMATH_USE_SSE4)
+    if (n >= 4) {
+      uint32_t lanes[4];
+      for (uint32_t k = 0, s = seed_; k != 4; k++) {
+        lanes[k] = s *= 16807;
+      }
+      __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+      const __m128i step = _mm_set1_epi32(static_cast<int>(pow16807(4)));
+      const __m128i mantissa = _mm_set1_epi32(0x007fffff);
+      const __m128i exponent = _mm_set1_epi32(0x40000000);
+      for (const size_t end = n & ~size_t(3); i != end; i += 4) {
+        const __m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(state, mantissa), exponent));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(f, _mm_set1_ps(2.0f))));
+        state = _mm_mullo_epi32(state, step);
+      }
+      seed_ *= pow16807(i);
+    }
+#endif
+    for (; i < n; i++) {
+      out[i] = random();
+    }
+  }
+
+ private:
+  // 16807^n mod 2^32
+  static constexpr uint32_t pow16807(size_t n) {
+    uint32_t result = 1;
+    for (uint32_t base = 16807; n; n >>= 1, base *= base) {
+      if (n & 1)
+        result *= base;
+    }
+    return result;
+  }
 };
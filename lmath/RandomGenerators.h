@@ -0,0 +1,275 @@
+/**
+ * \file RandomGenerators.h
+ * \brief
+ *
+ * High-quality jumpable PRNGs for parallel simulations (PCG32, xoshiro128+, xoshiro256++, Philox4x32-10)
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include "lmath/Random.h"
+
+// All generators share the LRandomDistributions API (randomInRange(), randomVector3InRange(), fill(), ...) and provide:
+//   uint32_t next()  - raw 32 bits
+//   void jump()      - skip a fixed huge number of steps, giving non-overlapping subsequences
+//   split()          - return a copy of this generator and jump() this one: the copy owns the current subsequence
+// For results which do not depend on the number of threads, seed one generator per work item (not per thread),
+// e.g. LRandomPhilox(seed, workItemIndex).
+
+namespace ldr {
+
+[[nodiscard]] inline uint64_t splitMix64(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+[[nodiscard]] inline uint32_t rotl32(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+[[nodiscard]] inline uint64_t rotl64(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+} // namespace ldr
+
+/// PCG32 (XSH-RR): https://www.pcg-random.org
+struct LRandomPCG32 : LRandomDistributions<LRandomPCG32> {
+  uint64_t state_ = 0x853c49e6748fea9bull;
+  uint64_t inc_ = 0xda3e39cb94b95bdbull;
+
+  LRandomPCG32() = default;
+  explicit LRandomPCG32(uint64_t seed, uint64_t stream = 0) : state_(0), inc_((stream << 1u) | 1u) {
+    next();
+    state_ += seed;
+    next();
+  }
+
+  uint32_t next() {
+    const uint64_t old = state_;
+    state_ = old * kMultiplier + inc_;
+    const uint32_t xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+    const uint32_t rot = static_cast<uint32_t>(old >> 59u);
+    return (xorShifted >> rot) | (xorShifted << ((0u - rot) & 31u));
+  }
+  float random() {
+    return ldr::uint32ToUnitFloat(next());
+  }
+  /// skip `delta` steps in O(log(delta))
+  void advance(uint64_t delta) {
+    uint64_t curMult = kMultiplier;
+    uint64_t curPlus = inc_;
+    uint64_t accMult = 1;
+    uint64_t accPlus = 0;
+    while (delta) {
+      if (delta & 1) {
+        accMult *= curMult;
+        accPlus = accPlus * curMult + curPlus;
+      }
+      curPlus = (curMult + 1) * curPlus;
+      curMult *= curMult;
+      delta >>= 1;
+    }
+    state_ = accMult * state_ + accPlus;
+  }
+  /// 2^48 steps
+  void jump() {
+    advance(1ull << 48);
+  }
+  LRandomPCG32 split() {
+    const LRandomPCG32 r = *this;
+    jump();
+    return r;
+  }
+
+ private:
+  static constexpr uint64_t kMultiplier = 6364136223846793005ull;
+};
+
+/// xoshiro128+ (fast floats, 2^128-1 period): https://prng.di.unimi.it
+struct LRandomXoshiro128Plus : LRandomDistributions<LRandomXoshiro128Plus> {
+  uint32_t s_[4] = {0x9e3779b9u, 0x243f6a88u, 0xb7e15162u, 0x6a09e667u};
+
+  LRandomXoshiro128Plus() = default;
+  explicit LRandomXoshiro128Plus(uint64_t seed) {
+    const uint64_t a = ldr::splitMix64(seed);
+    const uint64_t b = ldr::splitMix64(seed);
+    s_[0] = static_cast<uint32_t>(a);
+    s_[1] = static_cast<uint32_t>(a >> 32);
+    s_[2] = static_cast<uint32_t>(b);
+    s_[3] = static_cast<uint32_t>(b >> 32);
+  }
+
+  uint32_t next() {
+    const uint32_t result = s_[0] + s_[3];
+    const uint32_t t = s_[1] << 9;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = ldr::rotl32(s_[3], 11);
+    return result;
+  }
+  float random() {
+    // the lowest bits of xoshiro128+ are weak, only the upper 24 bits are used
+    return ldr::uint32ToUnitFloat(next());
+  }
+  /// 2^64 steps
+  void jump() {
+    constexpr uint32_t kJump[] = {0x8764000bu, 0xf542d2d3u, 0x6fa035c3u, 0x77f2db5bu};
+    uint32_t s[4] = {};
+    for (uint32_t j : kJump) {
+      for (int b = 0; b != 32; b++) {
+        if (j & (1u << b)) {
+          for (int i = 0; i != 4; i++)
+            s[i] ^= s_[i];
+        }
+        next();
+      }
+    }
+    for (int i = 0; i != 4; i++)
+      s_[i] = s[i];
+  }
+  LRandomXoshiro128Plus split() {
+    const LRandomXoshiro128Plus r = *this;
+    jump();
+    return r;
+  }
+};
+
+/// xoshiro256++ (all-purpose, 2^256-1 period): https://prng.di.unimi.it
+struct LRandomXoshiro256PlusPlus : LRandomDistributions<LRandomXoshiro256PlusPlus> {
+  uint64_t s_[4] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+
+  LRandomXoshiro256PlusPlus() = default;
+  explicit LRandomXoshiro256PlusPlus(uint64_t seed) {
+    for (uint64_t& s : s_)
+      s = ldr::splitMix64(seed);
+  }
+
+  uint64_t next64() {
+    const uint64_t result = ldr::rotl64(s_[0] + s_[3], 23) + s_[0];
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = ldr::rotl64(s_[3], 45);
+    return result;
+  }
+  uint32_t next() {
+    return static_cast<uint32_t>(next64() >> 32);
+  }
+  float random() {
+    return ldr::uint32ToUnitFloat(next());
+  }
+  /// 2^128 steps
+  void jump() {
+    constexpr uint64_t kJump[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+    uint64_t s[4] = {};
+    for (uint64_t j : kJump) {
+      for (int b = 0; b != 64; b++) {
+        if (j & (1ull << b)) {
+          for (int i = 0; i != 4; i++)
+            s[i] ^= s_[i];
+        }
+        next64();
+      }
+    }
+    for (int i = 0; i != 4; i++)
+      s_[i] = s[i];
+  }
+  LRandomXoshiro256PlusPlus split() {
+    const LRandomXoshiro256PlusPlus r = *this;
+    jump();
+    return r;
+  }
+};
+
+/// Philox4x32-10 counter-based generator (Salmon et al. 2011): the n-th block is a pure function of (key, n),
+/// so any position of any stream can be reached in O(1)
+struct LRandomPhilox : LRandomDistributions<LRandomPhilox> {
+  uint32_t key_[2] = {0, 0};
+  uint32_t counter_[4] = {0, 0, 0, 0};
+
+  LRandomPhilox() = default;
+  /// the upper 64 bits of the counter select the stream, the lower 64 bits are the position within it
+  explicit LRandomPhilox(uint64_t seed, uint64_t stream = 0) {
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = static_cast<uint32_t>(seed >> 32);
+    counter_[2] = static_cast<uint32_t>(stream);
+    counter_[3] = static_cast<uint32_t>(stream >> 32);
+  }
+
+  /// 10 rounds of Philox4x32 applied to `counter` with `key`
+  static void generateBlock(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+    uint32_t k[2] = {key[0], key[1]};
+    for (int round = 0; round != 10; round++) {
+      const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+      const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+      const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+      const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+      c[0] = hi1 ^ c[1] ^ k[0];
+      c[1] = lo1;
+      c[2] = hi0 ^ c[3] ^ k[1];
+      c[3] = lo0;
+      k[0] += 0x9E3779B9u;
+      k[1] += 0xBB67AE85u;
+    }
+    for (int i = 0; i != 4; i++)
+      out[i] = c[i];
+  }
+
+  uint32_t next() {
+    if (index_ == 4) {
+      generateBlock(counter_, key_, block_);
+      incrementCounter(1);
+      index_ = 0;
+    }
+    return block_[index_++];
+  }
+  float random() {
+    return ldr::uint32ToUnitFloat(next());
+  }
+  /// position the generator at the `blockIndex`-th 4x32-bit block of the current stream
+  void seek(uint64_t blockIndex) {
+    counter_[0] = static_cast<uint32_t>(blockIndex);
+    counter_[1] = static_cast<uint32_t>(blockIndex >> 32);
+    index_ = 4;
+  }
+  /// 2^64 blocks, i.e. the next stream
+  void jump() {
+    if (++counter_[2] == 0)
+      ++counter_[3];
+    index_ = 4;
+  }
+  LRandomPhilox split() {
+    const LRandomPhilox r = *this;
+    jump();
+    return r;
+  }
+
+ private:
+  void incrementCounter(uint32_t n) {
+    if ((counter_[0] += n) >= n)
+      return;
+    if (++counter_[1])
+      return;
+    if (++counter_[2])
+      return;
+    ++counter_[3];
+  }
+
+ private:
+  uint32_t block_[4] = {};
+  uint32_t index_ = 4;
+};
@@ -0,0 +1,167 @@
+/**
+ * \file RandomSampling.h
+ * \brief
+ *
+ * Batched rejection-free sampling of spheres, hemispheres, disks and triangles
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include "lmath/Random.h"
+#include "lmath/SIMD.h"
+
+// Every fill*() function works with any generator derived from LRandomDistributions: uniform numbers are generated
+// with its bulk fill() into SoA chunks which are mapped by branch-free SIMD kernels.
+
+namespace ldr {
+
+namespace detail {
+
+/// Run `kernel` over `NumIn` planes of uniform random numbers producing `NumOut` planes, then pass every element
+/// to `emit(index, const float* values, size_t stride)`
+template<size_t NumIn, size_t NumOut, class RNG, class Kernel, class Emit>
+void sampleBatch(RNG& rng, size_t n, const Kernel& kernel, const Emit& emit) {
+  constexpr size_t kChunk = 256;
+  float in[NumIn * kChunk];
+  float out[NumOut * kChunk];
+  for (size_t base = 0; base < n; base += kChunk) {
+    const size_t count = (n - base < kChunk) ? n - base : kChunk;
+    for (size_t k = 0; k != NumIn; k++) {
+      rng.fill(in + k * kChunk, count);
+    }
+    size_t i = 0;
+    for (; i + simd::f32xN::kWidth <= count; i += simd::f32xN::kWidth) {
+      kernel.template operator()<simd::f32xN>(in + i, out + i, kChunk);
+    }
+    for (; i != count; i++) {
+      kernel.template operator()<simd::f32x1>(in + i, out + i, kChunk);
+    }
+    for (size_t j = 0; j != count; j++) {
+      emit(base + j, out + j, kChunk);
+    }
+  }
+}
+
+// kernels: `in` and `out` point to the current element of planes separated by `stride` floats
+
+struct SphereSurfaceKernel {
+  template<class V>
+  void operator()(const float* in, float* out, size_t stride) const {
+    const V z = V(1.0f) - V(2.0f) * V::load(in);
+    const V r = simd::sqrt(simd::max(V(0.0f), V(1.0f) - z * z));
+    V s, c;
+    simd::sinCos2Pi(V::load(in + stride), s, c);
+    (r * c).store(out);
+    (r * s).store(out + stride);
+    z.store(out + 2 * stride);
+  }
+};
+
+struct SphereVolumeKernel {
+  template<class V>
+  void operator()(const float* in, float* out, size_t stride) const {
+    SphereSurfaceKernel().operator()<V>(in, out, stride);
+    // the maximum of 3 uniform numbers has CDF r^3, i.e. the same distribution as cbrt(u)
+    const V r = simd::max(V::load(in + 2 * stride), simd::max(V::load(in + 3 * stride), V::load(in + 4 * stride)));
+    for (size_t k = 0; k != 3; k++) {
+      (V::load(out + k * stride) * r).store(out + k * stride);
+    }
+  }
+};
+
+struct HemisphereKernel {
+  template<class V>
+  void operator()(const float* in, float* out, size_t stride) const {
+    const V z = V::load(in);
+    const V r = simd::sqrt(simd::max(V(0.0f), V(1.0f) - z * z));
+    V s, c;
+    simd::sinCos2Pi(V::load(in + stride), s, c);
+    (r * c).store(out);
+    (r * s).store(out + stride);
+    z.store(out + 2 * stride);
+  }
+};
+
+struct DiskKernel {
+  template<class V>
+  void operator()(const float* in, float* out, size_t stride) const {
+    const V r = simd::sqrt(V::load(in));
+    V s, c;
+    simd::sinCos2Pi(V::load(in + stride), s, c);
+    (r * c).store(out);
+    (r * s).store(out + stride);
+  }
+};
+
+struct CosineHemisphereKernel {
+  template<class V>
+  void operator()(const float* in, float* out, size_t stride) const {
+    DiskKernel().operator()<V>(in, out, stride);
+    // x^2 + y^2 == u
+    simd::sqrt(simd::max(V(0.0f), V(1.0f) - V::load(in))).store(out + 2 * stride);
+  }
+};
+
+struct TriangleKernel {
+  // barycentric coordinates of b and c
+  template<class V>
+  void operator()(const float* in, float* out, size_t stride) const {
+    const V su = simd::sqrt(V::load(in));
+    const V v = V::load(in + stride);
+    (su * (V(1.0f) - v)).store(out);
+    (su * v).store(out + stride);
+  }
+};
+
+} // namespace detail
+
+template<class RNG>
+void fillUnitSphereSurface(RNG& rng, RND_VEC3* out, size_t n) {
+  detail::sampleBatch<2, 3>(rng, n, detail::SphereSurfaceKernel(), [out](size_t i, const float* v, size_t stride) {
+    out[i] = RND_VEC3(v[0], v[stride], v[2 * stride]);
+  });
+}
+
+template<class RNG>
+void fillInsideUnitSphere(RNG& rng, RND_VEC3* out, size_t n) {
+  detail::sampleBatch<5, 3>(rng, n, detail::SphereVolumeKernel(), [out](size_t i, const float* v, size_t stride) {
+    out[i] = RND_VEC3(v[0], v[stride], v[2 * stride]);
+  });
+}
+
+/// hemisphere around +Z
+template<class RNG>
+void fillUnitHemisphere(RNG& rng, RND_VEC3* out, size_t n) {
+  detail::sampleBatch<2, 3>(rng, n, detail::HemisphereKernel(), [out](size_t i, const float* v, size_t stride) {
+    out[i] = RND_VEC3(v[0], v[stride], v[2 * stride]);
+  });
+}
+
+/// hemisphere around +Z, pdf = cos(theta)/pi
+template<class RNG>
+void fillCosineWeightedHemisphere(RNG& rng, RND_VEC3* out, size_t n) {
+  detail::sampleBatch<2, 3>(rng, n, detail::CosineHemisphereKernel(), [out](size_t i, const float* v, size_t stride) {
+    out[i] = RND_VEC3(v[0], v[stride], v[2 * stride]);
+  });
+}
+
+template<class RNG>
+void fillInsideUnitDisk(RNG& rng, RND_VEC2* out, size_t n) {
+  detail::sampleBatch<2, 2>(rng, n, detail::DiskKernel(), [out](size_t i, const float* v, size_t stride) {
+    out[i] = RND_VEC2(v[0], v[stride]);
+  });
+}
+
+/// uniformly distributed points inside the triangle (a, b, c)
+template<class RNG>
+void fillInsideTriangle(RNG& rng, RND_VEC3* out, size_t n, const RND_VEC3& a, const RND_VEC3& b, const RND_VEC3& c) {
+  detail::sampleBatch<2, 2>(rng, n, detail::TriangleKernel(), [out, &a, &b, &c](size_t i, const float* v, size_t stride) {
+    out[i] = a * (1.0f - v[0] - v[stride]) + b * v[0] + c * v[stride];
+  });
+}
+
+} // namespace ldr
@@ -0,0 +1,283 @@
+/**
+ * \file SIMD.h
+ * \brief
+ *
+ * Thin wrappers over SSE/AVX float and 16-bit integer lanes for writing a kernel once and instantiating it for every width
+ *
+ * \author Sergey Kosarevsky, 2026
+ * \author sk@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <cmath>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lutils/Macros.h"
+
+// clang-format off
+#if defined(LMATH_USE_AVX)
+#  include <immintrin.h>
+#elif defined(LMATH_USE_SSE4)
+#  include <smmintrin.h>
+#endif
+// clang-format on
+
+namespace ldr::simd {
+
+/// a single float lane: used for loop tails and as a reference implementation of kernels
+struct f32x1 {
+  static constexpr size_t kWidth = 1;
+  float v;
+  f32x1() = default;
+  f32x1(float f) : v(f) {}
+  static LFORCEINLINE f32x1 load(const float* p) {
+    return f32x1(*p);
+  }
+  LFORCEINLINE void store(float* p) const {
+    *p = v;
+  }
+};
+
+struct m32x1 {
+  bool v;
+};
+
+// clang-format off
+LFORCEINLINE f32x1 operator+(f32x1 a, f32x1 b) { return a.v + b.v; }
+LFORCEINLINE f32x1 operator-(f32x1 a, f32x1 b) { return a.v - b.v; }
+LFORCEINLINE f32x1 operator*(f32x1 a, f32x1 b) { return a.v * b.v; }
+LFORCEINLINE f32x1 operator/(f32x1 a, f32x1 b) { return a.v / b.v; }
+LFORCEINLINE m32x1 operator<(f32x1 a, f32x1 b) { return {a.v < b.v}; }
+LFORCEINLINE m32x1 operator>(f32x1 a, f32x1 b) { return {a.v > b.v}; }
+LFORCEINLINE m32x1 operator&(m32x1 a, m32x1 b) { return {a.v && b.v}; }
+LFORCEINLINE m32x1 operator|(m32x1 a, m32x1 b) { return {a.v || b.v}; }
+LFORCEINLINE f32x1 select(m32x1 m, f32x1 a, f32x1 b) { return m.v ? a : b; }
+LFORCEINLINE f32x1 min(f32x1 a, f32x1 b) { return a.v < b.v ? a : b; }
+LFORCEINLINE f32x1 max(f32x1 a, f32x1 b) { return a.v > b.v ? a : b; }
+LFORCEINLINE f32x1 abs(f32x1 a) { return std::fabs(a.v); }
+LFORCEINLINE f32x1 sqrt(f32x1 a) { return std::sqrt(a.v); }
+LFORCEINLINE f32x1 floor(f32x1 a) { return std::floor(a.v); }
+// clang-format on
+
+#if defined(LMATH_USE_SSE4)
+struct f32x4 {
+  static constexpr size_t kWidth = 4;
+  __m128 v;
+  f32x4() = default;
+  f32x4(__m128 m) : v(m) {}
+  f32x4(float f) : v(_mm_set1_ps(f)) {}
+  static LFORCEINLINE f32x4 load(const float* p) {
+    return _mm_loadu_ps(p);
+  }
+  LFORCEINLINE void store(float* p) const {
+    _mm_storeu_ps(p, v);
+  }
+};
+
+struct m32x4 {
+  __m128 v;
+};
+
+// clang-format off
+LFORCEINLINE f32x4 operator+(f32x4 a, f32x4 b) { return _mm_add_ps(a.v, b.v); }
+LFORCEINLINE f32x4 operator-(f32x4 a, f32x4 b) { return _mm_sub_ps(a.v, b.v); }
+LFORCEINLINE f32x4 operator*(f32x4 a, f32x4 b) { return _mm_mul_ps(a.v, b.v); }
+LFORCEINLINE f32x4 operator/(f32x4 a, f32x4 b) { return _mm_div_ps(a.v, b.v); }
+LFORCEINLINE m32x4 operator<(f32x4 a, f32x4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+LFORCEINLINE m32x4 operator>(f32x4 a, f32x4 b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+LFORCEINLINE m32x4 operator&(m32x4 a, m32x4 b) { return {_mm_and_ps(a.v, b.v)}; }
+LFORCEINLINE m32x4 operator|(m32x4 a, m32x4 b) { return {_mm_or_ps(a.v, b.v)}; }
+LFORCEINLINE f32x4 select(m32x4 m, f32x4 a, f32x4 b) { return _mm_blendv_ps(b.v, a.v, m.v); }
+LFORCEINLINE f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a.v, b.v); }
+LFORCEINLINE f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a.v, b.v); }
+LFORCEINLINE f32x4 abs(f32x4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+LFORCEINLINE f32x4 sqrt(f32x4 a) { return _mm_sqrt_ps(a.v); }
+LFORCEINLINE f32x4 floor(f32x4 a) { return _mm_floor_ps(a.v); }
+// clang-format on
+#endif // LMATH_USE_SSE4
+
+#if defined(LMATH_USE_AVX)
+struct f32x8 {
+  static constexpr size_t kWidth = 8;
+  __m256 v;
+  f32x8() = default;
+  f32x8(__m256 m) : v(m) {}
+  f32x8(float f) : v(_mm256_set1_ps(f)) {}
+  static LFORCEINLINE f32x8 load(const float* p) {
+    return _mm256_loadu_ps(p);
+  }
+  LFORCEINLINE void store(float* p) const {
+    _mm256_storeu_ps(p, v);
+  }
+};
+
+struct m32x8 {
+  __m256 v;
+};
+
+// clang-format off
+LFORCEINLINE f32x8 operator+(f32x8 a, f32x8 b) { return _mm256_add_ps(a.v, b.v); }
+LFORCEINLINE f32x8 operator-(f32x8 a, f32x8 b) { return _mm256_sub_ps(a.v, b.v); }
+LFORCEINLINE f32x8 operator*(f32x8 a, f32x8 b) { return _mm256_mul_ps(a.v, b.v); }
+LFORCEINLINE f32x8 operator/(f32x8 a, f32x8 b) { return _mm256_div_ps(a.v, b.v); }
+LFORCEINLINE m32x8 operator<(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+LFORCEINLINE m32x8 operator>(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+LFORCEINLINE m32x8 operator&(m32x8 a, m32x8 b) { return {_mm256_and_ps(a.v, b.v)}; }
+LFORCEINLINE m32x8 operator|(m32x8 a, m32x8 b) { return {_mm256_or_ps(a.v, b.v)}; }
+LFORCEINLINE f32x8 select(m32x8 m, f32x8 a, f32x8 b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+LFORCEINLINE f32x8 min(f32x8 a, f32x8 b) { return _mm256_min_ps(a.v, b.v); }
+LFORCEINLINE f32x8 max(f32x8 a, f32x8 b) { return _mm256_max_ps(a.v, b.v); }
+LFORCEINLINE f32x8 abs(f32x8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+LFORCEINLINE f32x8 sqrt(f32x8 a) { return _mm256_sqrt_ps(a.v); }
+LFORCEINLINE f32x8 floor(f32x8 a) { return _mm256_floor_ps(a.v); }
+// clang-format on
+#endif // LMATH_USE_AVX
+
+/// the widest lane type available for the current target
+#if defined(LMATH_USE_AVX)
+using f32xN = f32x8;
+#elif defined(LMATH_USE_SSE4)
+using f32xN = f32x4;
+#else
+using f32xN = f32x1;
+#endif
+
+/// 16-bit integer lanes holding 8-bit values: load() widens bytes, store() packs them back with saturation.
+/// Arithmetic wraps around, comparisons are only valid for values below 32768.
+struct u16x1 {
+  static constexpr size_t kWidth = 1;
+  uint16_t v;
+  u16x1() = default;
+  u16x1(uint16_t i) : v(i) {}
+  static LFORCEINLINE u16x1 load(const uint8_t* p) {
+    return u16x1(*p);
+  }
+  LFORCEINLINE void store(uint8_t* p) const {
+    *p = static_cast<uint8_t>(v > 255 ? 255 : v);
+  }
+};
+
+struct m16x1 {
+  bool v;
+};
+
+// clang-format off
+LFORCEINLINE u16x1 operator+(u16x1 a, u16x1 b) { return static_cast<uint16_t>(a.v + b.v); }
+LFORCEINLINE u16x1 operator-(u16x1 a, u16x1 b) { return static_cast<uint16_t>(a.v - b.v); }
+LFORCEINLINE u16x1 operator*(u16x1 a, u16x1 b) { return static_cast<uint16_t>(a.v * b.v); }
+LFORCEINLINE u16x1 operator|(u16x1 a, u16x1 b) { return static_cast<uint16_t>(a.v | b.v); }
+LFORCEINLINE m16x1 operator<(u16x1 a, u16x1 b) { return {a.v < b.v}; }
+LFORCEINLINE m16x1 operator>(u16x1 a, u16x1 b) { return {a.v > b.v}; }
+LFORCEINLINE u16x1 select(m16x1 m, u16x1 a, u16x1 b) { return m.v ? a : b; }
+LFORCEINLINE u16x1 min(u16x1 a, u16x1 b) { return a.v < b.v ? a : b; }
+LFORCEINLINE u16x1 max(u16x1 a, u16x1 b) { return a.v > b.v ? a : b; }
+LFORCEINLINE u16x1 subSat(u16x1 a, u16x1 b) { return static_cast<uint16_t>(a.v > b.v ? a.v - b.v : 0); }
+LFORCEINLINE u16x1 average(u16x1 a, u16x1 b) { return static_cast<uint16_t>((a.v + b.v + 1) >> 1); }
+LFORCEINLINE u16x1 div255(u16x1 a) { return static_cast<uint16_t>(((a.v + 128u) * 257u) >> 16); }
+// clang-format on
+
+#if defined(LMATH_USE_SSE4)
+struct u16x8 {
+  static constexpr size_t kWidth = 8;
+  __m128i v;
+  u16x8() = default;
+  u16x8(__m128i m) : v(m) {}
+  u16x8(uint16_t i) : v(_mm_set1_epi16(static_cast<short>(i))) {}
+  static LFORCEINLINE u16x8 load(const uint8_t* p) {
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+  }
+  LFORCEINLINE void store(uint8_t* p) const {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(v, v));
+  }
+};
+
+struct m16x8 {
+  __m128i v;
+};
+
+// clang-format off
+LFORCEINLINE u16x8 operator+(u16x8 a, u16x8 b) { return _mm_add_epi16(a.v, b.v); }
+LFORCEINLINE u16x8 operator-(u16x8 a, u16x8 b) { return _mm_sub_epi16(a.v, b.v); }
+LFORCEINLINE u16x8 operator*(u16x8 a, u16x8 b) { return _mm_mullo_epi16(a.v, b.v); }
+LFORCEINLINE u16x8 operator|(u16x8 a, u16x8 b) { return _mm_or_si128(a.v, b.v); }
+LFORCEINLINE m16x8 operator<(u16x8 a, u16x8 b) { return {_mm_cmplt_epi16(a.v, b.v)}; }
+LFORCEINLINE m16x8 operator>(u16x8 a, u16x8 b) { return {_mm_cmpgt_epi16(a.v, b.v)}; }
+LFORCEINLINE u16x8 select(m16x8 m, u16x8 a, u16x8 b) { return _mm_blendv_epi8(b.v, a.v, m.v); }
+LFORCEINLINE u16x8 min(u16x8 a, u16x8 b) { return _mm_min_epu16(a.v, b.v); }
+LFORCEINLINE u16x8 max(u16x8 a, u16x8 b) { return _mm_max_epu16(a.v, b.v); }
+LFORCEINLINE u16x8 subSat(u16x8 a, u16x8 b) { return _mm_subs_epu16(a.v, b.v); }
+LFORCEINLINE u16x8 average(u16x8 a, u16x8 b) { return _mm_avg_epu16(a.v, b.v); }
+LFORCEINLINE u16x8 div255(u16x8 a) { return _mm_mulhi_epu16(_mm_add_epi16(a.v, _mm_set1_epi16(128)), _mm_set1_epi16(257)); }
+// clang-format on
+#endif // LMATH_USE_SSE4
+
+#if defined(LMATH_USE_AVX2)
+struct u16x16 {
+  static constexpr size_t kWidth = 16;
+  __m256i v;
+  u16x16() = default;
+  u16x16(__m256i m) : v(m) {}
+  u16x16(uint16_t i) : v(_mm256_set1_epi16(static_cast<short>(i))) {}
+  static LFORCEINLINE u16x16 load(const uint8_t* p) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+  LFORCEINLINE void store(uint8_t* p) const {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+  }
+};
+
+struct m16x16 {
+  __m256i v;
+};
+
+// clang-format off
+LFORCEINLINE u16x16 operator+(u16x16 a, u16x16 b) { return _mm256_add_epi16(a.v, b.v); }
+LFORCEINLINE u16x16 operator-(u16x16 a, u16x16 b) { return _mm256_sub_epi16(a.v, b.v); }
+LFORCEINLINE u16x16 operator*(u16x16 a, u16x16 b) { return _mm256_mullo_epi16(a.v, b.v); }
+LFORCEINLINE u16x16 operator|(u16x16 a, u16x16 b) { return _mm256_or_si256(a.v, b.v); }
+LFORCEINLINE m16x16 operator<(u16x16 a, u16x16 b) { return {_mm256_cmpgt_epi16(b.v, a.v)}; }
+LFORCEINLINE m16x16 operator>(u16x16 a, u16x16 b) { return {_mm256_cmpgt_epi16(a.v, b.v)}; }
+LFORCEINLINE u16x16 select(m16x16 m, u16x16 a, u16x16 b) { return _mm256_blendv_epi8(b.v, a.v, m.v); }
+LFORCEINLINE u16x16 min(u16x16 a, u16x16 b) { return _mm256_min_epu16(a.v, b.v); }
+LFORCEINLINE u16x16 max(u16x16 a, u16x16 b) { return _mm256_max_epu16(a.v, b.v); }
+LFORCEINLINE u16x16 subSat(u16x16 a, u16x16 b) { return _mm256_subs_epu16(a.v, b.v); }
+LFORCEINLINE u16x16 average(u16x16 a, u16x16 b) { return _mm256_avg_epu16(a.v, b.v); }
+LFORCEINLINE u16x16 div255(u16x16 a) { return _mm256_mulhi_epu16(_mm256_add_epi16(a.v, _mm256_set1_epi16(128)), _mm256_set1_epi16(257)); }
+// clang-format on
+#endif // LMATH_USE_AVX2
+
+/// the widest 16-bit integer lane type available for the current target
+#if defined(LMATH_USE_AVX2)
+using u16xN = u16x16;
+#elif defined(LMATH_USE_SSE4)
+using u16xN = u16x8;
+#else
+using u16xN = u16x1;
+#endif
+
+/// Branch-free sin(2*pi*u) and cos(2*pi*u) for u in [0..1), absolute error < 1e-6
+template<class V>
+LFORCEINLINE void sinCos2Pi(V u, V& s, V& c) {
+  // t in [-pi..pi): sin(2*pi*u) = -sin(t), cos(2*pi*u) = -cos(t)
+  V t = (u - V(0.5f)) * V(6.28318530717958647692f);
+  // fold into [-pi/2..pi/2] where sin() is preserved and cos() changes its sign
+  const auto hi = t > V(1.57079632679489661923f);
+  const auto lo = t < V(-1.57079632679489661923f);
+  t = select(hi, V(3.14159265358979323846f) - t, select(lo, V(-3.14159265358979323846f) - t, t));
+  const V cosSign = select(hi | lo, V(1.0f), V(-1.0f));
+  // Taylor series up to x^11 and x^12 are accurate to ~1e-7 on [-pi/2..pi/2]
+  const V t2 = t * t;
+  const V sinT =
+      t * (V(1.0f) + t2 * (V(-1.0f / 6.0f) + t2 * (V(1.0f / 120.0f) + t2 * (V(-1.0f / 5040.0f) +
+                                                                             t2 * (V(1.0f / 362880.0f) + t2 * V(-1.0f / 39916800.0f))))));
+  const V cosT = V(1.0f) + t2 * (V(-0.5f) + t2 * (V(1.0f / 24.0f) + t2 * (V(-1.0f / 720.0f) +
+                                                                        t2 * (V(1.0f / 40320.0f) + t2 * (V(-1.0f / 3628800.0f) +
+                                                                                                          t2 * V(1.0f / 479001600.0f))))));
+  s = V(0.0f) - sinT;
+  c = cosSign * cosT;
+}
+
+} // namespace ldr::simd
@@ -0,0 +1,230 @@
+/**
+ * \file Serialization.h
+ * \brief
+ *
+ * Binary serialization of lmath types
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <bit>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+#include "lmath/Matrix.h"
+#include "lmath/Plane.h"
+#include "lmath/Ray.h"
+#include "lmath/Vector.h"
+
+// elements are stored exactly as they are laid out in memory, so the format is only readable zero-copy on little-endian hosts
+static_assert(std::endian::native == std::endian::little, "Serialized lmath arrays are little-endian");
+
+namespace ldr {
+
+/// Stored in files: never renumber
+enum eSerializedType : uint32_t {
+  eSerializedType_vec2 = 1,
+  eSerializedType_vec2i = 2,
+  eSerializedType_vec3 = 3,
+  eSerializedType_vec3i = 4,
+  eSerializedType_vec4 = 5,
+  eSerializedType_vec4i = 6,
+  eSerializedType_vec4b = 7,
+  eSerializedType_mat3 = 8,
+  eSerializedType_mat4 = 9,
+  eSerializedType_plane3 = 10,
+  eSerializedType_ray3 = 11,
+};
+
+template<typename T>
+struct SerializedTypeInfo;
+
+#define LDR_SERIALIZED_TYPE(T, Size)                                                                  \
+  template<>                                                                                          \
+  struct SerializedTypeInfo<T> {                                                                      \
+    static_assert(std::is_trivially_copyable_v<T>, #T " cannot be serialized with memcpy()");         \
+    static_assert(std::is_standard_layout_v<T>, #T " has no stable layout");                          \
+    static_assert(sizeof(T) == Size, #T " layout has changed: bump SerializedArrayHeader::kVersion"); \
+    static constexpr eSerializedType kType = eSerializedType_##T;                                     \
+  };
+
+LDR_SERIALIZED_TYPE(vec2, 8)
+LDR_SERIALIZED_TYPE(vec2i, 8)
+LDR_SERIALIZED_TYPE(vec3, 12)
+LDR_SERIALIZED_TYPE(vec3i, 12)
+LDR_SERIALIZED_TYPE(vec4, 16)
+LDR_SERIALIZED_TYPE(vec4i, 16)
+LDR_SERIALIZED_TYPE(vec4b, 4)
+LDR_SERIALIZED_TYPE(mat3, 36)
+LDR_SERIALIZED_TYPE(mat4, 64)
+LDR_SERIALIZED_TYPE(plane3, 16)
+LDR_SERIALIZED_TYPE(ray3, 24)
+
+#undef LDR_SERIALIZED_TYPE
+
+template<typename T>
+concept Serializable = requires { SerializedTypeInfo<T>::kType; };
+
+/// std::vector, std::span, C arrays... of Serializable elements
+template<typename Range>
+concept SerializableRange =
+    std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range> && Serializable<std::ranges::range_value_t<Range>>;
+
+/// Precedes every array. Elements start at sizeof(SerializedArrayHeader) and are padded to 16 bytes,
+/// so arrays written back to back stay aligned for zero-copy reads.
+struct SerializedArrayHeader {
+  static constexpr uint32_t kMagic = 0x5245534C; // "LSER"
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint32_t type = 0;
+  uint32_t elementSize = 0;
+  uint64_t count = 0;
+  uint64_t reserved = 0;
+};
+
+static_assert(sizeof(SerializedArrayHeader) == 32);
+
+/// the number of bytes taken by an array of `count` elements, including the header and padding
+template<Serializable T>
+constexpr size_t getSerializedSize(size_t count) {
+  return sizeof(SerializedArrayHeader) + ((count * sizeof(T) + 15) & ~size_t(15));
+}
+
+/// `out` should have getSerializedSize<T>(values.size()) bytes, returns the number of bytes written
+template<SerializableRange Range>
+size_t serializeArray(const Range& range, uint8_t* out) {
+  using T = std::ranges::range_value_t<Range>;
+
+  const std::span<const T> values(range);
+
+  SerializedArrayHeader header;
+  header.type = SerializedTypeInfo<T>::kType;
+  header.elementSize = sizeof(T);
+  header.count = values.size();
+
+  const size_t numBytes = values.size_bytes();
+  const size_t size = getSerializedSize<T>(values.size());
+
+  memcpy(out, &header, sizeof(header));
+  if (numBytes) {
+    memcpy(out + sizeof(header), values.data(), numBytes);
+  }
+  memset(out + sizeof(header) + numBytes, 0, size - sizeof(header) - numBytes);
+
+  return size;
+}
+
+/// append to `out`
+template<SerializableRange Range>
+void serializeArray(const Range& range, std::vector<uint8_t>& out) {
+  const size_t offset = out.size();
+  out.resize(offset + getSerializedSize<std::ranges::range_value_t<Range>>(std::ranges::size(range)));
+  serializeArray(range, out.data() + offset);
+}
+
+/// All elements are written with a single fwrite()
+template<SerializableRange Range>
+bool writeArray(FILE* file, const Range& range) {
+  using T = std::ranges::range_value_t<Range>;
+
+  const std::span<const T> values(range);
+
+  SerializedArrayHeader header;
+  header.type = SerializedTypeInfo<T>::kType;
+  header.elementSize = sizeof(T);
+  header.count = values.size();
+
+  const size_t numBytes = values.size_bytes();
+  const uint8_t padding[16] = {};
+  const size_t paddingSize = getSerializedSize<T>(values.size()) - sizeof(header) - numBytes;
+
+  if (fwrite(&header, sizeof(header), 1, file) != 1 || (numBytes && fwrite(values.data(), numBytes, 1, file) != 1) ||
+      (paddingSize && fwrite(padding, paddingSize, 1, file) != 1)) {
+    printf("Cannot write a serialized array\n");
+    return false;
+  }
+
+  return true;
+}
+
+namespace detail {
+
+template<Serializable T>
+bool readArrayHeader(std::span<const uint8_t> data, SerializedArrayHeader& header) {
+  if (data.size() < sizeof(header)) {
+    printf("Serialized array is truncated\n");
+    return false;
+  }
+
+  memcpy(&header, data.data(), sizeof(header));
+
+  if (header.magic != SerializedArrayHeader::kMagic || header.version != SerializedArrayHeader::kVersion) {
+    printf("Not a serialized lmath array (version %u)\n", header.version);
+    return false;
+  }
+  if (header.type != SerializedTypeInfo<T>::kType || header.elementSize != sizeof(T)) {
+    printf("Serialized array type mismatch (type %u, element size %u)\n", header.type, header.elementSize);
+    return false;
+  }
+  if (header.count > (data.size() - sizeof(header)) / sizeof(T)) {
+    printf("Serialized array is truncated\n");
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace detail
+
+/// Zero-copy view of an array at the beginning of `data`, e.g. a memory-mapped file. Advance by getSerializedSize<T>()
+/// to get to the next array. Fails if the header does not match T or the elements are not aligned for T.
+template<Serializable T>
+std::optional<std::span<const T>> viewArray(std::span<const uint8_t> data) {
+  SerializedArrayHeader header;
+
+  if (!detail::readArrayHeader<T>(data, header)) {
+    return std::nullopt;
+  }
+
+  const uint8_t* elements = data.data() + sizeof(header);
+
+  if (reinterpret_cast<uintptr_t>(elements) % alignof(T)) {
+    printf("Serialized array is misaligned\n");
+    return std::nullopt;
+  }
+
+  return std::span<const T>(reinterpret_cast<const T*>(elements), static_cast<size_t>(header.count));
+}
+
+/// Copy an array out of `data`: works for any alignment
+template<Serializable T>
+bool readArray(std::span<const uint8_t> data, std::vector<T>& values) {
+  SerializedArrayHeader header;
+
+  if (!detail::readArrayHeader<T>(data, header)) {
+    return false;
+  }
+
+  values.resize(static_cast<size_t>(header.count));
+  if (!values.empty()) {
+    memcpy(values.data(), data.data() + sizeof(header), values.size() * sizeof(T));
+  }
+
+  return true;
+}
+
+} // namespace ldr
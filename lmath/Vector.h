@@ -989,11 +989,12 @@ class vec4b {
   vec4b() {}; // do not default-initialize
   vec4b(uint8_t x, uint8_t y, uint8_t z, uint8_t w) : x(x), y(y), z(z), w(w) {};
   explicit vec4b(const uint8_t a) : x(a), y(a), z(a), w(a) {};
-  explicit vec4b(const vec4& v)
-  : x(static_cast<uint8_t>(v.x * 255.0f))
-  , y(static_cast<uint8_t>(v.y * 255.0f))
-  , z(static_cast<uint8_t>(v.z * 255.0f))
-  , w(static_cast<uint8_t>(v.w * 255.0f)) {};
+  /// clamps to [0..1] and rounds to the nearest integer
+  explicit vec4b(const vec4& v) : x(toUNorm8(v.x)), y(toUNorm8(v.y)), z(toUNorm8(v.z)), w(toUNorm8(v.w)) {};
+
+  static LFORCEINLINE uint8_t toUNorm8(float f) {
+    return static_cast<uint8_t>(ldr::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f);
+  }
 };
 
 } // namespace ldr
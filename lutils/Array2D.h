@@ -4,8 +4,8 @@
  *
  * Access a 1D array (vector) as a 2D array
  *
- * \version 1.0.1
- * \date 01/03/2026
+ * \version 1.2.0
+ * \date 18/10/2026
  * \author Sergey Kosarevsky, 2023-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
@@ -13,33 +13,188 @@
 
 #pragma once
 
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <new>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
 #include "Macros.h"
 
+#if defined(LMATH_USE_BMI2)
+#include <immintrin.h>
+#endif // LMATH_USE_BMI2
+
 namespace ldr {
 
-template<typename T>
+/// Interleave the bits of `x` (even bits) and `y` (odd bits)
+LFORCEINLINE uint64_t mortonEncode2D(uint32_t x, uint32_t y) {
+#if defined(LMATH_USE_BMI2)
+  return _pdep_u64(x, 0x5555555555555555ull) | _pdep_u64(y, 0xAAAAAAAAAAAAAAAAull);
+#else
+  auto spread = [](uint64_t v) {
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    v = (v | (v << 2)) & 0x3333333333333333ull;
+    v = (v | (v << 1)) & 0x5555555555555555ull;
+    return v;
+  };
+  return spread(x) | (spread(y) << 1);
+#endif // LMATH_USE_BMI2
+}
+
+/// Use as std::vector<T, AlignedAllocator<T, 64>> to get SIMD-friendly aligned rows with Array2DLinearLayout::alignStride()
+template<typename T, size_t Alignment>
+class AlignedAllocator {
+  static_assert(std::has_single_bit(Alignment) && Alignment >= alignof(T));
+
+ public:
+  typedef T value_type;
+  template<typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() = default;
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  [[nodiscard]] T* allocate(size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+  void deallocate(T* p, size_t) noexcept {
+    ::operator delete(p, std::align_val_t(Alignment));
+  }
+  template<typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+    return true;
+  }
+};
+
+/// Layouts map (i, j) to an index in the container and tell Array2D how many elements to allocate.
+/// kTileWidth x kTileHeight is the block size used by Array2D::forEachTile().
+
+/// Rows stored one after another: (i, j) -> j * stride + i, where stride >= width. Only this layout has contiguous rows.
+class Array2DLinearLayout {
+ public:
+  static constexpr size_t kTileWidth = 64;
+  static constexpr size_t kTileHeight = 64;
+
+  Array2DLinearLayout(size_t w, size_t h, size_t stride = 0) : stride_(std::max(w, stride)), height_(h) {}
+  LFORCEINLINE size_t getSize() const {
+    return stride_ * height_;
+  }
+  LFORCEINLINE size_t getIndex(size_t i, size_t j) const {
+    return j * stride_ + i;
+  }
+  LFORCEINLINE size_t getStride() const {
+    return stride_;
+  }
+  /// the smallest stride (in elements) which keeps every row aligned to `alignment` bytes
+  static constexpr size_t alignStride(size_t w, size_t elementSize, size_t alignment) {
+    const size_t rowSize = (w * elementSize + alignment - 1) / alignment * alignment;
+    return (rowSize % elementSize) ? alignStride(w + 1, elementSize, alignment) : rowSize / elementSize;
+  }
+
+ private:
+  size_t stride_ = 0;
+  size_t height_ = 0;
+};
+
+/// TileWidth x TileHeight tiles stored one after another (rows of tiles), every tile is row-major inside.
+/// Edge tiles are padded.
+template<size_t TileWidth = 32, size_t TileHeight = 32>
+class Array2DTiledLayout {
+  static_assert(std::has_single_bit(TileWidth) && std::has_single_bit(TileHeight), "Tile dimensions should be powers of 2");
+
+ public:
+  static constexpr size_t kTileWidth = TileWidth;
+  static constexpr size_t kTileHeight = TileHeight;
+
+  Array2DTiledLayout(size_t w, size_t h) : tilesX_((w + TileWidth - 1) / TileWidth), tilesY_((h + TileHeight - 1) / TileHeight) {}
+  LFORCEINLINE size_t getSize() const {
+    return tilesX_ * tilesY_ * TileWidth * TileHeight;
+  }
+  LFORCEINLINE size_t getIndex(size_t i, size_t j) const {
+    const size_t tile = (j / TileHeight) * tilesX_ + i / TileWidth;
+    return tile * (TileWidth * TileHeight) + (j % TileHeight) * TileWidth + (i % TileWidth);
+  }
+
+ private:
+  size_t tilesX_ = 0;
+  size_t tilesY_ = 0;
+};
+
+/// Z-order curve: both dimensions are padded to powers of 2, the low bits of (i, j) are interleaved while the remaining
+/// high bits of the longer dimension select one of the square Z-ordered blocks. Every aligned 2^k x 2^k block is contiguous.
+class Array2DMortonLayout {
+ public:
+  static constexpr size_t kTileWidth = 64;
+  static constexpr size_t kTileHeight = 64;
+
+  Array2DMortonLayout(size_t w, size_t h)
+  : bitsX_(std::bit_width(w > 1 ? w - 1 : 0))
+  , bitsY_(std::bit_width(h > 1 ? h - 1 : 0))
+  , bits_(std::min(bitsX_, bitsY_))
+  , mask_((size_t(1) << bits_) - 1) {}
+  LFORCEINLINE size_t getSize() const {
+    return size_t(1) << (bitsX_ + bitsY_);
+  }
+  /// the padded dimensions are 2^getNumBitsX() x 2^getNumBitsY()
+  size_t getNumBitsX() const {
+    return bitsX_;
+  }
+  size_t getNumBitsY() const {
+    return bitsY_;
+  }
+  LFORCEINLINE size_t getIndex(size_t i, size_t j) const {
+    // only one of (i >> bits_) and (j >> bits_) can be non-zero
+    return static_cast<size_t>(mortonEncode2D(static_cast<uint32_t>(i & mask_), static_cast<uint32_t>(j & mask_))) |
+           (((i | j) >> bits_) << (2 * bits_));
+  }
+
+ private:
+  size_t bitsX_ = 0;
+  size_t bitsY_ = 0;
+  size_t bits_ = 0;
+  size_t mask_ = 0;
+};
+
+template<typename T, typename Layout = Array2DLinearLayout>
 class Array2D {
  public:
   typedef typename T::value_type value_type;
+  typedef Layout layout_type;
 
  public:
   Array2D() = delete;
-  Array2D(size_t w, size_t h) : width_(w), height_(h), container_(w * h) {}
-  Array2D(const Array2D<T>&) = default;
-  Array2D(Array2D<T>&&) = default;
-  Array2D& operator=(const Array2D<T>&) = default;
-  Array2D& operator=(Array2D<T>&&) = default;
+  Array2D(size_t w, size_t h) : width_(w), height_(h), layout_(w, h), container_(layout_.getSize()) {}
+  Array2D(size_t w, size_t h, const Layout& layout) : width_(w), height_(h), layout_(layout), container_(layout_.getSize()) {}
+  /// adopt an existing container (e.g. a memory-mapped one) which holds at least layout.getSize() elements
+  Array2D(size_t w, size_t h, const Layout& layout, T&& container)
+  : width_(w), height_(h), layout_(layout), container_(std::move(container)) {
+    assert(container_.size() >= layout_.getSize());
+  }
+  Array2D(const Array2D&) = default;
+  Array2D(Array2D&&) = default;
+  Array2D& operator=(const Array2D&) = default;
+  Array2D& operator=(Array2D&&) = default;
   LFORCEINLINE const value_type& operator()(size_t i, size_t j) const {
-    return container_[j * width_ + i];
+    return container_[layout_.getIndex(i, j)];
   };
   LFORCEINLINE value_type& operator()(size_t i, size_t j) {
-    return container_[j * width_ + i];
+    return container_[layout_.getIndex(i, j)];
   };
   LFORCEINLINE value_type at(size_t i, size_t j) const {
-    return container_[j * width_ + i];
+    return container_[layout_.getIndex(i, j)];
   }; // a workaround for std::vector<bool>
   LFORCEINLINE void set(size_t i, size_t j, const value_type& val) {
-    container_[j * width_ + i] = val;
+    container_[layout_.getIndex(i, j)] = val;
   };
   LFORCEINLINE size_t getWidth() const {
     return width_;
@@ -47,10 +202,51 @@ class Array2D {
   LFORCEINLINE size_t getHeight() const {
     return height_;
   }
+  LFORCEINLINE const Layout& getLayout() const {
+    return layout_;
+  }
+  /// raw storage in the order defined by Layout, including padding
+  LFORCEINLINE value_type* data() {
+    return container_.data();
+  }
+  LFORCEINLINE const value_type* data() const {
+    return container_.data();
+  }
+  LFORCEINLINE size_t getStride() const
+    requires requires(const Layout& l) { l.getStride(); }
+  {
+    return layout_.getStride();
+  }
+  /// `width` contiguous elements of the row `j`
+  LFORCEINLINE std::span<value_type> row(size_t j)
+    requires requires(const Layout& l) { l.getStride(); }
+  {
+    return std::span<value_type>(container_.data() + j * layout_.getStride(), width_);
+  }
+  LFORCEINLINE std::span<const value_type> row(size_t j) const
+    requires requires(const Layout& l) { l.getStride(); }
+  {
+    return std::span<const value_type>(container_.data() + j * layout_.getStride(), width_);
+  }
+  /// Call `func(i0, j0, i1, j1)` for every Layout::kTileWidth x Layout::kTileHeight block [i0..i1) x [j0..j1) of the array,
+  /// tiles are visited row by row. A block occupies one contiguous range of the container (with padding when it is clipped
+  /// at the edge) only if it matches the storage blocks of the layout: with Array2DTiledLayout every block is exactly one
+  /// tile, with Array2DMortonLayout the blocks are power-of-2 squares (64x64) starting at multiples of 64, i.e. whole
+  /// Z-ordered blocks. Blocks of Array2DLinearLayout are not contiguous.
+  template<typename Func>
+  void forEachTile(Func&& func) const {
+    for (size_t j0 = 0; j0 < height_; j0 += Layout::kTileHeight) {
+      const size_t j1 = std::min(j0 + Layout::kTileHeight, height_);
+      for (size_t i0 = 0; i0 < width_; i0 += Layout::kTileWidth) {
+        func(i0, j0, std::min(i0 + Layout::kTileWidth, width_), j1);
+      }
+    }
+  }
 
  private:
   size_t width_ = 0;
   size_t height_ = 0;
+  Layout layout_;
   T container_;
 };
 
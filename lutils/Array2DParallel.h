@@ -0,0 +1,85 @@
+/**
+ * \file Array2DParallel.h
+ * \brief
+ *
+ * Parallel iteration over Array2D rows and tiles on the default ThreadPool
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+
+#include "Array2D.h"
+#include "ThreadPool.h"
+
+namespace ldr {
+
+namespace detail {
+
+/// run `func(threadIndex)` for `numThreads` indices (0 - one per hardware thread) on the default ThreadPool, the calling
+/// thread takes index 0
+template<typename Func>
+void runOnThreads(uint32_t numThreads, const Func& func) {
+  if (!numThreads) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  TaskGroup group;
+  for (uint32_t t = 1; t < numThreads; t++) {
+    group.run([&func, t]() { func(t); });
+  }
+  func(0u);
+  group.wait();
+}
+
+} // namespace detail
+
+/// Call `func(j0, j1)` for bands of rows [j0..j1) of `array`, one band per thread (0 - one thread per hardware thread)
+template<typename T, typename Layout, typename Func>
+void parallelForRows(const Array2D<T, Layout>& array, Func&& func, uint32_t numThreads = 0) {
+  const size_t height = array.getHeight();
+  if (!numThreads) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const size_t numBands = std::max<size_t>(1, std::min<size_t>(numThreads, height));
+  const size_t rowsPerBand = (height + numBands - 1) / numBands;
+  detail::runOnThreads(static_cast<uint32_t>(numBands), [&](uint32_t band) {
+    const size_t j0 = std::min(band * rowsPerBand, height);
+    const size_t j1 = std::min(j0 + rowsPerBand, height);
+    if (j0 != j1) {
+      func(j0, j1);
+    }
+  });
+}
+
+/// Same tiles as Array2D::forEachTile() handed out dynamically to `numThreads` threads
+template<typename T, typename Layout, typename Func>
+void parallelForTiles(const Array2D<T, Layout>& array, Func&& func, uint32_t numThreads = 0) {
+  const size_t width = array.getWidth();
+  const size_t height = array.getHeight();
+  const size_t tilesX = (width + Layout::kTileWidth - 1) / Layout::kTileWidth;
+  const size_t tilesY = (height + Layout::kTileHeight - 1) / Layout::kTileHeight;
+  const size_t numTiles = tilesX * tilesY;
+  if (!numThreads) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::atomic<size_t> nextTile = 0;
+  detail::runOnThreads(static_cast<uint32_t>(std::min<size_t>(numThreads, std::max<size_t>(1, numTiles))), [&](uint32_t) {
+    for (size_t t = nextTile.fetch_add(1, std::memory_order_relaxed); t < numTiles; t = nextTile.fetch_add(1, std::memory_order_relaxed)) {
+      const size_t i0 = (t % tilesX) * Layout::kTileWidth;
+      const size_t j0 = (t / tilesX) * Layout::kTileHeight;
+      func(i0, j0, std::min(i0 + Layout::kTileWidth, width), std::min(j0 + Layout::kTileHeight, height));
+    }
+  });
+}
+
+} // namespace ldr
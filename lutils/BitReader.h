@@ -0,0 +1,99 @@
+/**
+ * \file BitReader.h
+ * \brief
+ *
+ * Read bits written by BitWriter
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif // _MSC_VER
+
+namespace ldr {
+
+/// Read bits MSB-first from memory. A 64-bit accumulator is refilled with unaligned big-endian 64-bit loads without branches
+/// (except near the end of the buffer), so at least 56 bits can be peeked after every refill.
+/// Reading past the end returns zeros, check isOverrun().
+class BitReader final {
+ public:
+  BitReader(const uint8_t* buf, uint64_t bufSizeBytes) : buf_(buf), size_(bufSizeBytes) {
+    assert(buf || !bufSizeBytes);
+  }
+
+  /// look at the next `numBits` bits (up to 32) without consuming them
+  uint32_t peekBits(uint32_t numBits) {
+    assert(numBits <= 32);
+    if (accBits_ < numBits) {
+      refill();
+    }
+    // two shifts handle numBits == 0
+    return static_cast<uint32_t>((acc_ >> 1) >> (63 - numBits));
+  }
+  /// skip bits which were peeked before
+  void consumeBits(uint32_t numBits) {
+    assert(numBits <= accBits_);
+    acc_ <<= numBits;
+    accBits_ -= numBits;
+  }
+  uint32_t readBits(uint32_t numBits) {
+    const uint32_t bits = peekBits(numBits);
+    consumeBits(numBits);
+    return bits;
+  }
+  /// the number of bits consumed so far
+  uint64_t getNumBits() const {
+    return pos_ * 8 - accBits_;
+  }
+  /// true if more bits were consumed than the buffer has
+  bool isOverrun() const {
+    return getNumBits() > size_ * 8;
+  }
+  /// top up the accumulator to at least 56 bits. It is done automatically by peekBits(), calling it explicitly once per
+  /// decoded symbol makes the refill branch-free and predictable in tight decoding loops.
+  void refill() {
+    if (pos_ + 8 <= size_) {
+      uint64_t word;
+      memcpy(&word, buf_ + pos_, sizeof(word));
+#if defined(_MSC_VER)
+      word = _byteswap_uint64(word);
+#else
+      word = __builtin_bswap64(word);
+#endif
+      acc_ |= word >> accBits_;
+      // advance by whole bytes only, the rest of the loaded bits will be loaded again next time
+      pos_ += (63 - accBits_) >> 3;
+      accBits_ |= 56;
+    } else {
+      // the tail: byte by byte, padded with zeros
+      while (accBits_ <= 56) {
+        const uint64_t byte = pos_ < size_ ? buf_[pos_] : 0;
+        acc_ |= byte << (56 - accBits_);
+        pos_++;
+        accBits_ += 8;
+      }
+    }
+  }
+
+ private:
+  const uint8_t* buf_ = nullptr;
+  uint64_t size_ = 0;
+  // the next byte to load
+  uint64_t pos_ = 0;
+  // unread bits are MSB-aligned, the bits below `accBits_` are either zeros or the next bits of the stream
+  uint64_t acc_ = 0;
+  uint32_t accBits_ = 0;
+};
+
+} // namespace ldr
@@ -2,41 +2,214 @@
  * \file BitWriter.h
  * \brief
  *
- * Write bits to memory
+ * Write bits to memory, growable buffers or streams
  *
- * \version 1.0.0
- * \date 04/03/2023
- * \author Sergey Kosarevsky, 2023
+ * \version 1.2.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2023-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
  */
 
 #pragma once
 
+#include <algorithm>
 #include <assert.h>
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif // _MSC_VER
 
 namespace ldr {
 
-/// Write bits to memory assuming outBuf is preinitialized to all zeros
-class BitWriter final {
+/// Sinks hand BitWriterT a window [cur, end) of writable memory:
+///   getWindow(cur, end)              - the initial window
+///   grow(cur, end, numBytes)         - the window is full: provide at least `numBytes` bytes at `cur`
+///   commit(cur, end, hasPartialByte) - bytes before `cur` are final, *cur holds the padded last byte if `hasPartialByte`
+
+/// A fixed caller-supplied buffer, overflows are asserted
+class BitSinkBuffer {
  public:
-  BitWriter(uint8_t* outBuf, uint32_t bufSizeBytes) : buf_(outBuf), bitCount_(bufSizeBytes << 3) {
+  BitSinkBuffer(uint8_t* outBuf, uint32_t bufSizeBytes) : buf_(outBuf), size_(bufSizeBytes) {
     assert(outBuf);
     assert(bufSizeBytes);
   }
+  void getWindow(uint8_t*& cur, uint8_t*& end) {
+    cur = buf_;
+    end = buf_ + size_;
+  }
+  void grow(uint8_t*&, uint8_t*&, size_t) {
+    assert(!"BitWriter buffer overflow");
+  }
+  void commit(uint8_t*&, uint8_t*&, bool) {}
+
+ private:
+  uint8_t* buf_ = nullptr;
+  uint32_t size_ = 0;
+};
+
+/// Append to a std::vector, growing it geometrically. The vector has the exact size after every flush().
+class BitSinkVector {
+ public:
+  explicit BitSinkVector(std::vector<uint8_t>& out) : out_(out), start_(out.size()) {}
+  void getWindow(uint8_t*& cur, uint8_t*& end) {
+    out_.resize(start_ + 256);
+    cur = out_.data() + start_;
+    end = out_.data() + out_.size();
+  }
+  void grow(uint8_t*& cur, uint8_t*& end, size_t numBytes) {
+    const size_t used = cur - out_.data();
+    out_.resize(std::max(2 * out_.size(), used + numBytes));
+    cur = out_.data() + used;
+    end = out_.data() + out_.size();
+  }
+  void commit(uint8_t*& cur, uint8_t*& end, bool hasPartialByte) {
+    const size_t used = cur - out_.data();
+    out_.resize(used + (hasPartialByte ? 1 : 0));
+    cur = out_.data() + used;
+    end = out_.data() + out_.size();
+  }
+
+ private:
+  std::vector<uint8_t>& out_;
+  size_t start_ = 0;
+};
+
+/// Pass every filled ChunkSize-byte chunk to a callback (write to a file, socket, etc): the memory use is bounded.
+/// A partial last byte is only passed to the callback by BitWriterT::finish().
+template<size_t ChunkSize = 64 * 1024>
+class BitSinkStream {
+  static_assert(ChunkSize >= 4);
+
+ public:
+  typedef std::function<void(const uint8_t* data, size_t size)> Callback;
+
+  explicit BitSinkStream(Callback callback) : callback_(std::move(callback)) {
+    assert(callback_);
+  }
+  BitSinkStream(const BitSinkStream&) = delete;
+  BitSinkStream& operator=(const BitSinkStream&) = delete;
+  void getWindow(uint8_t*& cur, uint8_t*& end) {
+    cur = chunk_;
+    end = chunk_ + ChunkSize;
+  }
+  void grow(uint8_t*& cur, uint8_t*& end, [[maybe_unused]] size_t numBytes) {
+    assert(numBytes <= ChunkSize);
+    commit(cur, end, false);
+  }
+  void commit(uint8_t*& cur, uint8_t*& end, bool) {
+    if (cur != chunk_) {
+      callback_(chunk_, cur - chunk_);
+    }
+    getWindow(cur, end);
+  }
+
+ private:
+  Callback callback_;
+  uint8_t chunk_[ChunkSize];
+};
+
+/// Write bits MSB-first (the first bit goes into the highest bit of the first byte) into a Sink.
+/// Bits are collected in a 64-bit accumulator and stored as big-endian 32-bit words; the buffer does not need to be cleared.
+/// The tail is written by flush()/finish() or by the destructor, the last byte is padded with zeros.
+template<typename Sink>
+class BitWriterT final {
+ public:
+  template<typename... Args>
+  explicit BitWriterT(Args&&... args) : sink_(std::forward<Args>(args)...) {
+    sink_.getWindow(cur_, end_);
+  }
+  ~BitWriterT() {
+    finish();
+  }
+  BitWriterT(const BitWriterT&) = delete;
+  BitWriterT& operator=(const BitWriterT&) = delete;
 
-  // numBits - the number of bits to use from 'bits' (starting from the highest value bits)
+  // numBits - the number of bits to use from 'bits' (starting from the highest value bits), up to 32
   void writeBits(uint32_t bits, uint32_t numBits) {
-    assert(bitPos_ + numBits <= bitCount_);
-    while (numBits-- > 0) {
-      buf_[bitPos_++ >> 3] |= ((bits >> numBits) & 1) << (7 - (bitPos_ & 7));
+    assert(numBits <= 32);
+    // garbage above the lowest `accBits_` bits is shifted out or ignored
+    acc_ = (acc_ << numBits) | (bits & (uint32_t(uint64_t(1) << numBits) - 1u));
+    accBits_ += numBits;
+    bitPos_ += numBits;
+    if (accBits_ >= 32) {
+      accBits_ -= 32;
+      storeWord(static_cast<uint32_t>(acc_ >> accBits_));
     }
   }
+  /// Pass all complete bytes to the sink. In-memory sinks also get the last partial byte padded with zeros,
+  /// it is rewritten when more bits are written.
+  void flush() {
+    const uint32_t numBytes = (accBits_ + 7) >> 3;
+    if (end_ - cur_ < ptrdiff_t(numBytes)) {
+      sink_.grow(cur_, end_, numBytes);
+    }
+    uint32_t numBits = accBits_;
+    while (numBits >= 8) {
+      numBits -= 8;
+      *cur_++ = static_cast<uint8_t>(acc_ >> numBits);
+    }
+    accBits_ = numBits;
+    if (numBits) {
+      *cur_ = static_cast<uint8_t>(acc_ << (8 - numBits));
+    }
+    sink_.commit(cur_, end_, numBits != 0);
+  }
+  /// pad the stream with zeros to a byte boundary and flush it
+  void finish() {
+    const uint32_t padding = (8 - (accBits_ & 7)) & 7;
+    acc_ <<= padding;
+    accBits_ += padding;
+    bitPos_ += padding;
+    flush();
+  }
+  /// the number of bits written so far
+  uint64_t getNumBits() const {
+    return bitPos_;
+  }
+  /// the number of bytes touched by flush()
+  uint64_t getNumBytes() const {
+    return (bitPos_ + 7) >> 3;
+  }
+  Sink& getSink() {
+    return sink_;
+  }
 
  private:
-  uint8_t* buf_ = nullptr;
+  void storeWord(uint32_t word) {
+    if (end_ - cur_ < 4) {
+      sink_.grow(cur_, end_, 4);
+    }
+#if defined(_MSC_VER)
+    word = _byteswap_ulong(word);
+#else
+    word = __builtin_bswap32(word);
+#endif
+    memcpy(cur_, &word, sizeof(word));
+    cur_ += 4;
+  }
+
+ private:
+  Sink sink_;
+  uint8_t* cur_ = nullptr;
+  uint8_t* end_ = nullptr;
   uint64_t bitPos_ = 0;
-  uint64_t bitCount_ = 0;
+  uint64_t acc_ = 0;
+  uint32_t accBits_ = 0;
 };
 
+/// a fixed caller-supplied buffer of `bufSizeBytes` bytes
+using BitWriter = BitWriterT<BitSinkBuffer>;
+/// appends to a std::vector<uint8_t>
+using BitWriterVector = BitWriterT<BitSinkVector>;
+/// streams ChunkSize-byte chunks to a callback
+template<size_t ChunkSize = 64 * 1024>
+using BitWriterStream = BitWriterT<BitSinkStream<ChunkSize>>;
+
 } // namespace ldr
@@ -0,0 +1,262 @@
+/**
+ * \file ConcurrentQueue.h
+ * \brief
+ *
+ * Bounded lock-free SPSC and MPMC ring buffers
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+#include "lmath/Math.h"
+
+namespace ldr {
+
+/// std::hardware_destructive_interference_size is not stable across compiler flags, so it is not used in headers
+inline constexpr size_t kCacheLineSize = 64;
+
+// Both queues are non-blocking: push fails when the queue is full, pop fails when it is empty. The capacity is rounded up
+// to a power of 2. Slots hold live T objects, so T should be default-constructible and move-assignable.
+
+/// One producer thread and one consumer thread. Each side caches the other side's index and only touches
+/// the shared cache line when the cached value says the queue is full/empty.
+template<typename T>
+class SPSCQueue final {
+ public:
+  explicit SPSCQueue(uint32_t capacity)
+  : capacity_(isPowerOf2(capacity) ? capacity : getNextPowerOf2(capacity))
+  , mask_(capacity_ - 1)
+  , slots_(std::make_unique<T[]>(capacity_)) {
+    assert(capacity && capacity_);
+  }
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  uint32_t capacity() const {
+    return static_cast<uint32_t>(capacity_);
+  }
+  /// approximate when called concurrently with push/pop
+  size_t size() const {
+    const size_t head = head_.value.load(std::memory_order_acquire);
+    return tail_.value.load(std::memory_order_acquire) - head;
+  }
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /// producer
+  template<typename U>
+  bool tryPush(U&& value) {
+    const size_t tail = tail_.value.load(std::memory_order_relaxed);
+    if (tail - producerHead_ == capacity_) {
+      producerHead_ = head_.value.load(std::memory_order_acquire);
+      if (tail - producerHead_ == capacity_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = std::forward<U>(value);
+    tail_.value.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  /// producer: moves as many leading `values` as fit and publishes them at once, returns the number pushed
+  size_t tryPushBatch(std::span<T> values) {
+    const size_t tail = tail_.value.load(std::memory_order_relaxed);
+    if (capacity_ - (tail - producerHead_) < values.size()) {
+      producerHead_ = head_.value.load(std::memory_order_acquire);
+    }
+    const size_t n = std::min(values.size(), capacity_ - (tail - producerHead_));
+    for (size_t i = 0; i != n; i++) {
+      slots_[(tail + i) & mask_] = std::move(values[i]);
+    }
+    if (n) {
+      tail_.value.store(tail + n, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /// consumer
+  bool tryPop(T& value) {
+    const size_t head = head_.value.load(std::memory_order_relaxed);
+    if (head == consumerTail_) {
+      consumerTail_ = tail_.value.load(std::memory_order_acquire);
+      if (head == consumerTail_) {
+        return false;
+      }
+    }
+    value = std::move(slots_[head & mask_]);
+    head_.value.store(head + 1, std::memory_order_release);
+    return true;
+  }
+  /// consumer: fills the beginning of `values`, returns the number of popped elements
+  size_t tryPopBatch(std::span<T> values) {
+    const size_t head = head_.value.load(std::memory_order_relaxed);
+    if (consumerTail_ - head < values.size()) {
+      consumerTail_ = tail_.value.load(std::memory_order_acquire);
+    }
+    const size_t n = std::min(values.size(), consumerTail_ - head);
+    for (size_t i = 0; i != n; i++) {
+      values[i] = std::move(slots_[(head + i) & mask_]);
+    }
+    if (n) {
+      head_.value.store(head + n, std::memory_order_release);
+    }
+    return n;
+  }
+
+ private:
+  struct alignas(kCacheLineSize) PaddedIndex {
+    std::atomic<size_t> value = 0;
+  };
+
+  const size_t capacity_;
+  const size_t mask_;
+  const std::unique_ptr<T[]> slots_;
+
+  // written by the consumer
+  PaddedIndex head_;
+  alignas(kCacheLineSize) size_t consumerTail_ = 0;
+  // written by the producer
+  PaddedIndex tail_;
+  alignas(kCacheLineSize) size_t producerHead_ = 0;
+};
+
+/// Any number of producers and consumers (D. Vyukov's bounded queue). Every slot carries a sequence number telling
+/// whether it is ready to be written or read at the current lap, so producers and consumers only contend on their own index.
+template<typename T>
+class MPMCQueue final {
+ public:
+  explicit MPMCQueue(uint32_t capacity)
+  : capacity_(isPowerOf2(capacity) ? capacity : getNextPowerOf2(capacity))
+  , mask_(capacity_ - 1)
+  , slots_(std::make_unique<Slot[]>(capacity_)) {
+    assert(capacity && capacity_);
+    for (size_t i = 0; i != capacity_; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  uint32_t capacity() const {
+    return static_cast<uint32_t>(capacity_);
+  }
+  /// approximate when called concurrently with push/pop
+  size_t size() const {
+    const size_t head = head_.value.load(std::memory_order_acquire);
+    const size_t tail = tail_.value.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+  bool empty() const {
+    return size() == 0;
+  }
+
+  template<typename U>
+  bool tryPush(U&& value) {
+    size_t tail = 0;
+    const size_t n = claim<kPush>(tail_, tail, 1);
+    if (!n) {
+      return false;
+    }
+    Slot& slot = slots_[tail & mask_];
+    slot.value = std::forward<U>(value);
+    slot.sequence.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  /// claims as many consecutive free slots as available (up to values.size()) with a single CAS, returns the number pushed
+  size_t tryPushBatch(std::span<T> values) {
+    size_t tail = 0;
+    const size_t n = claim<kPush>(tail_, tail, values.size());
+    for (size_t i = 0; i != n; i++) {
+      Slot& slot = slots_[(tail + i) & mask_];
+      slot.value = std::move(values[i]);
+      slot.sequence.store(tail + i + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+  bool tryPop(T& value) {
+    size_t head = 0;
+    const size_t n = claim<kPop>(head_, head, 1);
+    if (!n) {
+      return false;
+    }
+    Slot& slot = slots_[head & mask_];
+    value = std::move(slot.value);
+    slot.sequence.store(head + capacity_, std::memory_order_release);
+    return true;
+  }
+  /// claims as many consecutive ready slots as available (up to values.size()) with a single CAS, returns the number popped
+  size_t tryPopBatch(std::span<T> values) {
+    size_t head = 0;
+    const size_t n = claim<kPop>(head_, head, values.size());
+    for (size_t i = 0; i != n; i++) {
+      Slot& slot = slots_[(head + i) & mask_];
+      values[i] = std::move(slot.value);
+      slot.sequence.store(head + i + capacity_, std::memory_order_release);
+    }
+    return n;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+  struct alignas(kCacheLineSize) PaddedIndex {
+    std::atomic<size_t> value = 0;
+  };
+
+  // a slot at position `pos` is writable when its sequence is `pos` and readable when it is `pos + 1`
+  static constexpr size_t kPush = 0;
+  static constexpr size_t kPop = 1;
+
+  template<size_t Offset>
+  size_t claim(PaddedIndex& index, size_t& pos, size_t maxCount) {
+    pos = index.value.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t n = 0;
+      while (n != maxCount) {
+        const size_t sequence = slots_[(pos + n) & mask_].sequence.load(std::memory_order_acquire);
+        if (sequence != pos + n + Offset) {
+          break;
+        }
+        n++;
+      }
+      if (!n) {
+        // either the queue is full/empty or another thread has moved the index: reload and retry in the latter case
+        const size_t sequence = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+        if (static_cast<ptrdiff_t>(sequence - (pos + Offset)) < 0) {
+          return 0;
+        }
+        pos = index.value.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (index.value.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+        return n;
+      }
+    }
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  const std::unique_ptr<Slot[]> slots_;
+
+  PaddedIndex head_;
+  PaddedIndex tail_;
+};
+
+} // namespace ldr
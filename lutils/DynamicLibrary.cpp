@@ -4,16 +4,20 @@
  *
  * Cross-platform dynamic link libraries (.dll/.so)
  *
- * \version 1.0.0
- * \date 13/03/2023
- * \author Sergey Kosarevsky, 2023
+ * \version 1.2.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2023-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
  */
 
 #include "DynamicLibrary.h"
 
+#include <assert.h>
+#include <chrono>
+#include <filesystem>
 #include <stdio.h>
+#include <string.h>
 
 // clang-format off
 #if defined(_WIN32)
@@ -21,49 +25,251 @@
 #  include <windows.h>
 #else
 #  include <dlfcn.h>
+#  include <unistd.h>
 #endif
 // clang-format on
 
-bool ldr::DynamicLibrary::load(const char* fileName) {
+namespace {
+
+double getElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint32_t getProcessId() {
+#if defined(_WIN32)
+  return static_cast<uint32_t>(::GetCurrentProcessId());
+#else
+  return static_cast<uint32_t>(::getpid());
+#endif
+}
+
+} // namespace
+
+bool ldr::DynamicLibrary::load(const char* fileName, uint32_t flags) {
+  unload();
+
+  const auto start = std::chrono::steady_clock::now();
+
 #if defined(_WIN32)
-  handle_ = (void*)::LoadLibrary(fileName);
+  void* handle = nullptr;
+
+  // Windows always binds imports eagerly and has no RTLD_GLOBAL, only NoLoad has a meaning here
+  if (flags & eDynamicLibraryFlags_NoLoad) {
+    HMODULE module = nullptr;
+    // takes a reference, balanced by FreeLibrary() in unload()
+    handle = ::GetModuleHandleExA(0, fileName, &module) ? (void*)module : nullptr;
+  } else {
+    handle = (void*)::LoadLibrary(fileName);
+  }
 
-  if (!handle_) {
+  if (!handle) {
     printf("Failed to load %s (error %lu)\n", fileName, ::GetLastError());
   }
 #else
-  handle_ = dlopen(fileName, RTLD_LAZY);
+  int mode = (flags & eDynamicLibraryFlags_Now) ? RTLD_NOW : RTLD_LAZY;
+  mode |= (flags & eDynamicLibraryFlags_Global) ? RTLD_GLOBAL : RTLD_LOCAL;
+  if (flags & eDynamicLibraryFlags_NoLoad) {
+    mode |= RTLD_NOLOAD;
+  }
 
-  const char* errStr = dlerror();
+  void* handle = dlopen(fileName, mode);
 
-  if (errStr != nullptr) {
-    printf("Failed to load %s (%s)\n", fileName, errStr);
-    handle_ = nullptr;
+  if (!handle) {
+    const char* errStr = dlerror();
+    printf("Failed to load %s (%s)\n", fileName, errStr ? errStr : "not loaded");
   }
 #endif
+
+  std::lock_guard lock(mutex_);
+
+  handle_ = handle;
+  stats_.loadTimeMs = getElapsedMs(start);
+
   return handle_ != nullptr;
 }
 
-ldr::DynamicLibrary::~DynamicLibrary() {
+void ldr::DynamicLibrary::unload() {
+  std::lock_guard lock(mutex_);
+
   if (handle_) {
 #if defined(_WIN32)
     FreeLibrary((HMODULE)handle_);
 #else
     dlclose(handle_);
 #endif
+    handle_ = nullptr;
   }
+
+  cache_.clear();
+  stats_ = {};
 }
 
-void* ldr::DynamicLibrary::getProcAddress(const char* procName) const {
-#if defined(_WIN32)
-  FARPROC proc = ::GetProcAddress((HMODULE)handle_, procName);
+ldr::DynamicLibrary::~DynamicLibrary() {
+  unload();
+}
 
-  return (void*)(proc);
-#else
-  void* proc = dlsym(handle_, procName);
+// the OS lookup, called under the lock
+void* ldr::DynamicLibrary::resolve(const char* procName) const {
+  stats_.numLookups++;
+
+  const auto it = cache_.find(std::string_view(procName));
+
+  if (it != cache_.end()) {
+    stats_.numCacheHits++;
+    return it->second;
+  }
 
-  const char* errStr = dlerror();
+  const auto start = std::chrono::steady_clock::now();
 
-  return errStr == nullptr ? proc : nullptr;
+#if defined(_WIN32)
+  void* proc = handle_ ? (void*)::GetProcAddress((HMODULE)handle_, procName) : nullptr;
+#else
+  void* proc = handle_ ? dlsym(handle_, procName) : nullptr;
 #endif
+
+  stats_.resolveTimeMs += getElapsedMs(start);
+
+  // missing symbols are cached as well
+  cache_.emplace(procName, proc);
+
+  return proc;
+}
+
+void* ldr::DynamicLibrary::getProcAddress(const char* procName) const {
+  std::lock_guard lock(mutex_);
+
+  return resolve(procName);
+}
+
+bool ldr::DynamicLibrary::bindSymbols(std::span<const DynamicLibrarySymbol> symbols) const {
+  std::lock_guard lock(mutex_);
+
+  cache_.reserve(cache_.size() + symbols.size());
+
+  bool result = true;
+
+  for (const DynamicLibrarySymbol& s : symbols) {
+    void* proc = resolve(s.name);
+
+    memcpy(s.slot, &proc, sizeof(proc));
+
+    if (!proc && !s.optional) {
+      printf("Missing symbol %s\n", s.name);
+      result = false;
+    }
+  }
+
+  return result;
+}
+
+ldr::DynamicLibraryStats ldr::DynamicLibrary::getStats() const {
+  std::lock_guard lock(mutex_);
+
+  return stats_;
+}
+
+bool ldr::loadLibraries(std::span<const DynamicLibraryLoadRequest> requests, std::span<DynamicLibrary> libraries, ThreadPool& pool) {
+  assert(requests.size() == libraries.size());
+
+  const size_t numLibraries = requests.size();
+
+  std::vector<std::atomic<uint32_t>> numPending(numLibraries);
+  std::vector<std::vector<uint32_t>> dependents(numLibraries);
+  std::vector<uint32_t> ready;
+
+  for (uint32_t i = 0; i != numLibraries; i++) {
+    numPending[i].store(static_cast<uint32_t>(requests[i].dependencies.size()), std::memory_order_relaxed);
+    for (uint32_t dep : requests[i].dependencies) {
+      assert(dep < numLibraries);
+      dependents[dep].push_back(i);
+    }
+    if (requests[i].dependencies.empty()) {
+      ready.push_back(i);
+    }
+  }
+
+  // reject cycles before loading anything (Kahn's algorithm)
+  {
+    std::vector<uint32_t> pending(numLibraries);
+    for (uint32_t i = 0; i != numLibraries; i++) {
+      pending[i] = numPending[i].load(std::memory_order_relaxed);
+    }
+    std::vector<uint32_t> queue = ready;
+    for (size_t k = 0; k != queue.size(); k++) {
+      for (uint32_t d : dependents[queue[k]]) {
+        if (!--pending[d]) {
+          queue.push_back(d);
+        }
+      }
+    }
+    if (queue.size() != numLibraries) {
+      printf("Cyclic dependencies: %zu libraries cannot be ordered\n", numLibraries - queue.size());
+      return false;
+    }
+  }
+
+  std::vector<std::atomic<bool>> isSkipped(numLibraries);
+  std::atomic<bool> result = true;
+
+  TaskGroup group(pool);
+
+  // a failed library takes its whole subtree with it: the dependents never reach zero pending dependencies
+  auto skipDependents = [&](uint32_t i) {
+    std::vector<uint32_t> skipped = dependents[i];
+    while (!skipped.empty()) {
+      const uint32_t s = skipped.back();
+      skipped.pop_back();
+      if (!isSkipped[s].exchange(true, std::memory_order_relaxed)) {
+        printf("Skipping %s: a dependency failed to load\n", requests[s].fileName);
+        skipped.insert(skipped.end(), dependents[s].begin(), dependents[s].end());
+      }
+    }
+  };
+
+  std::function<void(uint32_t)> loadLibrary = [&](uint32_t i) {
+    if (!libraries[i].load(requests[i].fileName, requests[i].flags)) {
+      result.store(false, std::memory_order_relaxed);
+      skipDependents(i);
+      return;
+    }
+    // the last dependency to finish schedules the dependent
+    for (uint32_t d : dependents[i]) {
+      if (numPending[d].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        group.run([&loadLibrary, d]() { loadLibrary(d); });
+      }
+    }
+  };
+
+  for (uint32_t i : ready) {
+    group.run([&loadLibrary, i]() { loadLibrary(i); });
+  }
+
+  group.wait();
+
+  return result.load(std::memory_order_relaxed);
+}
+
+std::string ldr::detail::makeReloadCopy(const std::string& fileName, uint32_t generation) {
+  const std::filesystem::path path(fileName);
+
+  std::error_code ec;
+
+  // unique per process and generation: the OS loader returns the already loaded library for a known path
+  const std::filesystem::path copy = std::filesystem::temp_directory_path(ec) /
+                                     (path.stem().string() + ".reload." + std::to_string(getProcessId()) + "." +
+                                      std::to_string(generation) + path.extension().string());
+
+  if (ec || !std::filesystem::copy_file(path, copy, std::filesystem::copy_options::overwrite_existing, ec) || ec) {
+    printf("Failed to copy %s for reloading (%s)\n", fileName.c_str(), ec.message().c_str());
+    return std::string();
+  }
+
+  return copy.string();
+}
+
+void ldr::detail::removeReloadCopy(const std::string& fileName) {
+  if (!fileName.empty()) {
+    std::error_code ec;
+    std::filesystem::remove(fileName, ec);
+  }
 }
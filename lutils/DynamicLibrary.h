@@ -4,31 +4,346 @@
  *
  * Cross-platform dynamic link libraries (.dll/.so)
  *
- * \version 1.0.0
- * \date 13/03/2023
- * \author Sergey Kosarevsky, 2023
+ * \version 1.2.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2023-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
  */
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "ThreadPool.h"
+
 namespace ldr {
 
-/// Cross-platform dynamic link libraries
+enum eDynamicLibraryFlags : uint32_t {
+  /// resolve functions on first call (RTLD_LAZY)
+  eDynamicLibraryFlags_Lazy = 0,
+  /// resolve all relocations in load(), missing dependencies fail early (RTLD_NOW)
+  eDynamicLibraryFlags_Now = 1 << 0,
+  /// make the symbols available to libraries loaded later (RTLD_GLOBAL), the default is RTLD_LOCAL
+  eDynamicLibraryFlags_Global = 1 << 1,
+  /// only succeed if the library is already loaded into the process, e.g. preloaded or linked (RTLD_NOLOAD)
+  eDynamicLibraryFlags_NoLoad = 1 << 2,
+};
+
+/// A function pointer slot filled by DynamicLibrary::bindSymbols()
+struct DynamicLibrarySymbol {
+  const char* name = nullptr;
+  /// points to a function pointer variable
+  void* slot = nullptr;
+  /// a missing optional symbol leaves nullptr in the slot and does not fail the binding
+  bool optional = false;
+};
+
+template<typename F>
+DynamicLibrarySymbol makeDynamicLibrarySymbol(const char* name, F*& fn, bool optional = false) {
+  return DynamicLibrarySymbol{name, &fn, optional};
+}
+
+/// time spent in the OS loader, all counters are accumulated until unload()
+struct DynamicLibraryStats {
+  double loadTimeMs = 0;
+  double resolveTimeMs = 0;
+  uint32_t numLookups = 0;
+  uint32_t numCacheHits = 0;
+};
+
+/// Cross-platform dynamic link libraries. Resolved symbols (including missing ones) are cached, lookups are thread-safe.
 class DynamicLibrary {
  public:
   DynamicLibrary() = default;
   ~DynamicLibrary();
+  DynamicLibrary(const DynamicLibrary&) = delete;
+  DynamicLibrary& operator=(const DynamicLibrary&) = delete;
 
   void* getProcAddress(const char* procName) const;
-  bool load(const char* fileName);
+  template<typename F>
+  F* getProc(const char* procName) const {
+    return reinterpret_cast<F*>(getProcAddress(procName));
+  }
+  /// Resolve all `symbols` in one pass under one lock. Returns false if any non-optional symbol is missing,
+  /// all of them are reported.
+  bool bindSymbols(std::span<const DynamicLibrarySymbol> symbols) const;
+
+  bool load(const char* fileName, uint32_t flags = eDynamicLibraryFlags_Lazy);
+  void unload();
   bool isLoaded() const {
     return handle_ != nullptr;
   }
+  DynamicLibraryStats getStats() const;
+
+ private:
+  void* resolve(const char* procName) const;
 
  private:
+  // heterogeneous lookup: no std::string is constructed for cache hits
+  struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const {
+      return std::hash<std::string_view>()(s);
+    }
+  };
+
   void* handle_ = nullptr;
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, void*, StringHash, std::equal_to<>> cache_;
+  mutable DynamicLibraryStats stats_;
+};
+
+struct DynamicLibraryLoadRequest {
+  const char* fileName = nullptr;
+  uint32_t flags = eDynamicLibraryFlags_Lazy;
+  /// indices of requests which should be loaded before this one (e.g. providing eDynamicLibraryFlags_Global symbols)
+  std::vector<uint32_t> dependencies;
+};
+
+/// Load libraries[i] from requests[i] as tasks on `pool`, the calling thread helps until everything is done. A library is
+/// submitted once all its dependencies are loaded; if a dependency fails, its dependents are not loaded.
+/// Returns false if anything failed to load or the dependencies have a cycle (nothing is loaded then).
+bool loadLibraries(std::span<const DynamicLibraryLoadRequest> requests,
+                   std::span<DynamicLibrary> libraries,
+                   ThreadPool& pool = ThreadPool::getDefault());
+
+namespace detail {
+
+/// copy `fileName` to a unique temporary file, so that a new version can be loaded while the old one is still mapped
+std::string makeReloadCopy(const std::string& fileName, uint32_t generation);
+void removeReloadCopy(const std::string& fileName);
+
+} // namespace detail
+
+/// A library which is reloaded when its file changes. Functions are called through a Table, a struct of function pointers
+/// filled by DynamicLibrary::bindSymbols() from the list returned by BindFunc.
+/// Every version is loaded from its own temporary copy. poll() loads and binds the new version next to the old one and swaps
+/// the tables atomically; the old library is unloaded by a later poll() once no Guard references it, and its Version is freed
+/// after two reader epochs have passed, i.e. once no acquire() which could have seen it is still running.
+template<typename Table>
+class HotReloadLibrary {
+ private:
+  static constexpr uint64_t kNotRetired = ~uint64_t(0);
+
+  struct Version {
+    DynamicLibrary library;
+    Table table = {};
+    std::string copyName;
+    uint32_t generation = 0;
+    std::atomic<uint32_t> numCalls = 0;
+    bool unloaded = false;
+    // the reader epoch observed after this version stopped being current
+    uint64_t retireEpoch = kNotRetired;
+  };
+
+ public:
+  using BindFunc = std::function<std::vector<DynamicLibrarySymbol>(Table& table)>;
+
+  /// Keeps the version it was acquired from loaded. Do not hold guards across poll() calls on the same thread forever.
+  class Guard {
+   public:
+    Guard() = default;
+    Guard(Guard&& other) noexcept : version_(std::exchange(other.version_, nullptr)) {}
+    Guard& operator=(Guard&& other) noexcept {
+      if (this != &other) {
+        release();
+        version_ = std::exchange(other.version_, nullptr);
+      }
+      return *this;
+    }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard() {
+      release();
+    }
+    explicit operator bool() const {
+      return version_ != nullptr;
+    }
+    const Table& operator*() const {
+      return version_->table;
+    }
+    const Table* operator->() const {
+      return &version_->table;
+    }
+    uint32_t getGeneration() const {
+      return version_ ? version_->generation : 0;
+    }
+
+   private:
+    friend class HotReloadLibrary;
+    explicit Guard(Version* version) : version_(version) {}
+    void release() {
+      if (version_) {
+        version_->numCalls.fetch_sub(1, std::memory_order_release);
+        version_ = nullptr;
+      }
+    }
+
+   private:
+    Version* version_ = nullptr;
+  };
+
+  HotReloadLibrary() = default;
+  ~HotReloadLibrary() {
+    unload();
+  }
+  HotReloadLibrary(const HotReloadLibrary&) = delete;
+  HotReloadLibrary& operator=(const HotReloadLibrary&) = delete;
+
+  /// `flags` default to eDynamicLibraryFlags_Now, so that a broken build is rejected by reload() rather than crashing later
+  bool load(const char* fileName, BindFunc bind, uint32_t flags = eDynamicLibraryFlags_Now) {
+    unload();
+    fileName_ = fileName;
+    bind_ = std::move(bind);
+    flags_ = flags;
+    return watcher_.watch(fileName) && reload();
+  }
+  /// Load and bind the current file, then swap it in. On failure the previous version stays active.
+  bool reload() {
+    auto version = std::make_unique<Version>();
+    version->generation = ++generation_;
+    version->copyName = detail::makeReloadCopy(fileName_, version->generation);
+
+    if (version->copyName.empty() || !version->library.load(version->copyName.c_str(), flags_) ||
+        !version->library.bindSymbols(bind_(version->table))) {
+      version->library.unload();
+      detail::removeReloadCopy(version->copyName);
+      return false;
+    }
+
+    // seq_cst pairs with acquire(): after this store no new call can start on the old version unnoticed
+    Version* previous = current_.exchange(version.get(), std::memory_order_seq_cst);
+    if (previous) {
+      previous->retireEpoch = epoch_.load(std::memory_order_seq_cst);
+    }
+    versions_.push_back(std::move(version));
+
+    collectRetired();
+
+    return true;
+  }
+  /// Call regularly from one thread: reloads the library if its file changed and unloads retired versions.
+  /// Returns true if a new version was swapped in.
+  bool poll() {
+    const bool reloaded = watcher_.poll() && reload();
+    collectRetired();
+    return reloaded;
+  }
+  /// Blocks until all Guards are released, so do not call it from a thread which holds one
+  void unload() {
+    watcher_.stop();
+    current_.store(nullptr, std::memory_order_seq_cst);
+    // two epochs: every acquire() which could have loaded a version has left, only Guards can reference versions now
+    for (uint32_t i = 0; i != 2; i++) {
+      while (!tryAdvanceEpoch()) {
+        std::this_thread::yield();
+      }
+    }
+    for (const std::unique_ptr<Version>& v : versions_) {
+      while (v->numCalls.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      if (!v->unloaded) {
+        v->library.unload();
+        detail::removeReloadCopy(v->copyName);
+      }
+    }
+    versions_.clear();
+  }
+  /// the current version; empty if nothing is loaded. Lock-free, safe to call from any thread.
+  Guard acquire() const {
+    const uint64_t epoch = enterReader();
+    Guard guard;
+    for (;;) {
+      Version* version = current_.load(std::memory_order_seq_cst);
+      if (!version) {
+        break;
+      }
+      version->numCalls.fetch_add(1, std::memory_order_seq_cst);
+      // the version could have been retired between the two lines above: its library stays loaded only if it is still current
+      if (current_.load(std::memory_order_seq_cst) == version) {
+        guard = Guard(version);
+        break;
+      }
+      version->numCalls.fetch_sub(1, std::memory_order_release);
+    }
+    numReaders_[epoch & 1].fetch_sub(1, std::memory_order_release);
+    return guard;
+  }
+  /// the number of libraries loaded at the moment, including retired versions with calls in flight
+  uint32_t getNumLoadedVersions() const {
+    uint32_t n = 0;
+    for (const std::unique_ptr<Version>& v : versions_) {
+      n += v->unloaded ? 0 : 1;
+    }
+    return n;
+  }
+
+ private:
+  // readers register in the counter of their epoch parity; the epoch is rechecked, so that a reader never lands in a
+  // counter which tryAdvanceEpoch() has already seen drained
+  uint64_t enterReader() const {
+    for (;;) {
+      const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+      numReaders_[epoch & 1].fetch_add(1, std::memory_order_seq_cst);
+      if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+        return epoch;
+      }
+      numReaders_[epoch & 1].fetch_sub(1, std::memory_order_release);
+    }
+  }
+  // E -> E+1 once all readers of E-1 (the same parity as E+1) have left; afterwards only readers of E and E+1 can be inside
+  bool tryAdvanceEpoch() {
+    const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    if (numReaders_[(epoch + 1) & 1].load(std::memory_order_seq_cst)) {
+      return false;
+    }
+    epoch_.store(epoch + 1, std::memory_order_seq_cst);
+    return true;
+  }
+  void collectRetired() {
+    const Version* current = current_.load(std::memory_order_seq_cst);
+    for (const std::unique_ptr<Version>& v : versions_) {
+      // a late acquire() may still bump the counter of a retired version, but it never returns a Guard for it
+      if (v.get() != current && !v->unloaded && !v->numCalls.load(std::memory_order_seq_cst)) {
+        v->library.unload();
+        detail::removeReloadCopy(v->copyName);
+        v->unloaded = true;
+      }
+    }
+    if (versions_.size() == 1 || !tryAdvanceEpoch()) {
+      return;
+    }
+    // a version retired at epoch R could only be seen by readers of epochs <= R, which are gone once the epoch reaches R+2
+    const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    std::erase_if(versions_, [epoch](const std::unique_ptr<Version>& v) {
+      return v->unloaded && v->retireEpoch != kNotRetired && v->retireEpoch + 2 <= epoch;
+    });
+  }
+
+ private:
+  std::string fileName_;
+  BindFunc bind_;
+  uint32_t flags_ = eDynamicLibraryFlags_Now;
+  uint32_t generation_ = 0;
+  FileWatcher watcher_;
+  std::vector<std::unique_ptr<Version>> versions_;
+  std::atomic<Version*> current_ = nullptr;
+  std::atomic<uint64_t> epoch_ = 0;
+  mutable std::atomic<uint32_t> numReaders_[2] = {};
 };
 
 } // namespace ldr
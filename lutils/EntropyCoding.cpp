@@ -0,0 +1,235 @@
+/**
+ * \file EntropyCoding.cpp
+ * \brief
+ *
+ * Entropy coders on top of BitWriter/BitReader: Elias-gamma, Golomb-Rice, LEB128 varints, Huffman and interleaved rANS
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "EntropyCoding.h"
+
+#include <functional>
+#include <numeric>
+#include <queue>
+
+namespace {
+
+// plain Huffman code lengths for the used symbols, the tree is built with a priority queue
+void computeHuffmanLengths(std::span<const uint32_t> frequencies, std::vector<uint8_t>& lengths) {
+  struct Node {
+    uint64_t weight;
+    uint32_t parent;
+  };
+
+  std::vector<Node> nodes;
+  nodes.reserve(2 * frequencies.size());
+
+  using Item = std::pair<uint64_t, uint32_t>; // (weight, node)
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+
+  // leaves go first: node `i` for the i-th used symbol
+  std::vector<uint32_t> leafSymbols;
+
+  for (uint32_t s = 0; s != frequencies.size(); s++) {
+    if (frequencies[s]) {
+      queue.emplace(frequencies[s], static_cast<uint32_t>(nodes.size()));
+      nodes.push_back({frequencies[s], ~0u});
+      leafSymbols.push_back(s);
+    }
+  }
+
+  if (leafSymbols.empty()) {
+    return;
+  }
+
+  if (leafSymbols.size() == 1) {
+    // a single symbol still needs one bit to be decodable
+    lengths[leafSymbols[0]] = 1;
+    return;
+  }
+
+  while (queue.size() > 1) {
+    const Item a = queue.top();
+    queue.pop();
+    const Item b = queue.top();
+    queue.pop();
+    const uint32_t parent = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({a.first + b.first, ~0u});
+    nodes[a.second].parent = parent;
+    nodes[b.second].parent = parent;
+    queue.emplace(a.first + b.first, parent);
+  }
+
+  // parents are always created after their children: walk backwards to get depths in one pass
+  std::vector<uint32_t> depth(nodes.size(), 0);
+  for (size_t i = nodes.size() - 1; i-- > 0;) {
+    depth[i] = depth[nodes[i].parent] + 1;
+  }
+  for (size_t i = 0; i != leafSymbols.size(); i++) {
+    lengths[leafSymbols[i]] = static_cast<uint8_t>(std::min<uint32_t>(depth[i], 255));
+  }
+}
+
+// clamp code lengths to `maxLength` and lengthen the cheapest codes until the Kraft inequality holds again
+void limitHuffmanLengths(std::span<const uint32_t> frequencies, std::vector<uint8_t>& lengths, uint32_t maxLength) {
+  const uint64_t kraftLimit = uint64_t(1) << maxLength;
+
+  uint64_t kraft = 0;
+  for (uint8_t& len : lengths) {
+    if (len) {
+      len = static_cast<uint8_t>(std::min<uint32_t>(len, maxLength));
+      kraft += uint64_t(1) << (maxLength - len);
+    }
+  }
+
+  if (kraft <= kraftLimit) {
+    return;
+  }
+
+  // the least frequent symbols are lengthened first
+  std::vector<uint32_t> order;
+  for (uint32_t s = 0; s != lengths.size(); s++) {
+    if (lengths[s]) {
+      order.push_back(s);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return frequencies[a] < frequencies[b]; });
+
+  while (kraft > kraftLimit) {
+    // the longest code which can still grow releases the smallest amount of code space
+    uint32_t best = ~0u;
+    for (uint32_t s : order) {
+      if (lengths[s] < maxLength && (best == ~0u || lengths[s] > lengths[best])) {
+        best = s;
+      }
+    }
+    assert(best != ~0u);
+    kraft -= uint64_t(1) << (maxLength - lengths[best] - 1);
+    lengths[best]++;
+  }
+}
+
+} // namespace
+
+ldr::HuffmanCodec::HuffmanCodec(std::span<const uint32_t> frequencies, uint32_t maxCodeLength) {
+  assert(frequencies.size() <= 65536);
+  assert(maxCodeLength && maxCodeLength <= kMaxCodeLength);
+  assert(std::count_if(frequencies.begin(), frequencies.end(), [](uint32_t f) { return f != 0; }) <= (1 << maxCodeLength));
+
+  lengths_.assign(frequencies.size(), 0);
+
+  computeHuffmanLengths(frequencies, lengths_);
+  limitHuffmanLengths(frequencies, lengths_, maxCodeLength);
+  buildCodes();
+}
+
+ldr::HuffmanCodec ldr::HuffmanCodec::fromCodeLengths(std::span<const uint8_t> codeLengths) {
+  assert(codeLengths.size() <= 65536);
+
+  HuffmanCodec codec;
+  codec.lengths_.assign(codeLengths.begin(), codeLengths.end());
+  codec.buildCodes();
+  return codec;
+}
+
+// canonical codes: shorter codes first, symbols in increasing order within the same length
+void ldr::HuffmanCodec::buildCodes() {
+  maxLength_ = 0;
+  uint32_t numCodes[kMaxCodeLength + 1] = {};
+  for (uint8_t len : lengths_) {
+    assert(len <= kMaxCodeLength);
+    numCodes[len]++;
+    maxLength_ = std::max<uint32_t>(maxLength_, len);
+  }
+  numCodes[0] = 0;
+
+  uint32_t nextCode[kMaxCodeLength + 1] = {};
+  for (uint32_t len = 1, code = 0; len <= kMaxCodeLength; len++) {
+    code = (code + numCodes[len - 1]) << 1;
+    nextCode[len] = code;
+  }
+
+  codes_.assign(lengths_.size(), 0);
+  table_.assign(size_t(1) << maxLength_, Entry{0, 0});
+
+  for (uint32_t s = 0; s != lengths_.size(); s++) {
+    const uint32_t len = lengths_[s];
+    if (!len) {
+      continue;
+    }
+    const uint32_t code = nextCode[len]++;
+    codes_[s] = code;
+    // every table index starting with `code` decodes to `s`
+    const uint32_t first = code << (maxLength_ - len);
+    const uint32_t last = (code + 1) << (maxLength_ - len);
+    assert(last <= table_.size() && "Code lengths violate the Kraft inequality");
+    std::fill(table_.begin() + first, table_.begin() + last, Entry{static_cast<uint16_t>(s), static_cast<uint8_t>(len)});
+  }
+}
+
+uint64_t ldr::HuffmanCodec::getEncodedSize(std::span<const uint32_t> frequencies) const {
+  assert(frequencies.size() <= lengths_.size());
+
+  uint64_t numBits = 0;
+  for (size_t s = 0; s != frequencies.size(); s++) {
+    numBits += uint64_t(frequencies[s]) * lengths_[s];
+  }
+  return numBits;
+}
+
+ldr::RansModel::RansModel(std::span<const uint32_t> frequencies, uint32_t scaleBits) : scaleBits_(scaleBits) {
+  assert(frequencies.size() <= 256);
+  assert(scaleBits >= 8 && scaleBits <= 15);
+
+  const uint32_t total = 1u << scaleBits;
+  const uint64_t sum = std::accumulate(frequencies.begin(), frequencies.end(), uint64_t(0));
+
+  if (!sum) {
+    return;
+  }
+
+  uint32_t scaledSum = 0;
+
+  for (uint32_t s = 0; s != frequencies.size(); s++) {
+    if (!frequencies[s]) {
+      continue;
+    }
+    // every used symbol keeps at least one slot
+    const uint32_t f = std::max<uint32_t>(1, static_cast<uint32_t>(uint64_t(frequencies[s]) * total / sum));
+    freq_[s] = static_cast<uint16_t>(f);
+    scaledSum += freq_[s];
+  }
+
+  // fix the rounding errors on the most frequent symbols where they cost the least
+  while (scaledSum != total) {
+    uint32_t best = 0;
+    for (uint32_t s = 0; s != frequencies.size(); s++) {
+      if (freq_[s] > freq_[best]) {
+        best = s;
+      }
+    }
+    if (scaledSum < total) {
+      const uint32_t delta = total - scaledSum;
+      freq_[best] = static_cast<uint16_t>(freq_[best] + delta);
+      scaledSum += delta;
+    } else {
+      // the largest frequency is always > 1 here, otherwise the sum would fit
+      const uint32_t delta = std::min<uint32_t>(scaledSum - total, freq_[best] - 1);
+      freq_[best] = static_cast<uint16_t>(freq_[best] - delta);
+      scaledSum -= delta;
+    }
+  }
+
+  slots_.resize(total);
+
+  for (uint32_t s = 0, start = 0; s != 256; s++) {
+    start_[s] = static_cast<uint16_t>(start);
+    std::fill(slots_.begin() + start, slots_.begin() + start + freq_[s], static_cast<uint8_t>(s));
+    start += freq_[s];
+  }
+}
@@ -0,0 +1,293 @@
+/**
+ * \file EntropyCoding.h
+ * \brief
+ *
+ * Entropy coders on top of BitWriter/BitReader: Elias-gamma, Golomb-Rice, LEB128 varints, Huffman and interleaved rANS
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "BitReader.h"
+#include "Macros.h"
+
+namespace ldr {
+
+/// Elias-gamma: `value` >= 1 is written as bit_width(value)-1 zeros followed by `value` itself
+template<typename Writer>
+void writeEliasGamma(Writer& writer, uint32_t value) {
+  assert(value);
+  const uint32_t numBits = std::bit_width(value);
+  writer.writeBits(0, numBits - 1);
+  writer.writeBits(value, numBits);
+}
+/// returns 0 for corrupted streams
+inline uint32_t readEliasGamma(BitReader& reader) {
+  const uint32_t numZeros = std::countl_zero(reader.peekBits(32));
+  if (numZeros == 32) {
+    return 0;
+  }
+  reader.consumeBits(numZeros);
+  return reader.readBits(numZeros + 1);
+}
+
+/// Golomb-Rice with the divisor 2^k: (value >> k) in unary as ones terminated by a zero, then the lowest `k` bits
+template<typename Writer>
+void writeGolombRice(Writer& writer, uint32_t value, uint32_t k) {
+  assert(k <= 31);
+  uint32_t q = value >> k;
+  for (; q >= 32; q -= 32) {
+    writer.writeBits(~0u, 32);
+  }
+  writer.writeBits(((1u << q) - 1u) << 1, q + 1);
+  writer.writeBits(value, k);
+}
+inline uint32_t readGolombRice(BitReader& reader, uint32_t k) {
+  assert(k <= 31);
+  uint32_t q = 0;
+  for (;;) {
+    // the reader returns zeros past the end, so this always terminates
+    const uint32_t numOnes = std::countl_one(reader.peekBits(32));
+    if (numOnes < 32) {
+      reader.consumeBits(numOnes + 1);
+      q += numOnes;
+      break;
+    }
+    reader.consumeBits(32);
+    q += 32;
+  }
+  return (q << k) | reader.readBits(k);
+}
+
+/// map signed values to unsigned so that small magnitudes get small codes: 0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...
+constexpr uint64_t zigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+constexpr int64_t zigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/// LEB128: 7 bits per byte, the highest bit is set when more bytes follow. Up to 10 bytes are written.
+inline size_t encodeVarint(uint64_t value, uint8_t* out) {
+  size_t n = 0;
+  for (; value >= 0x80; value >>= 7) {
+    out[n++] = static_cast<uint8_t>(value | 0x80);
+  }
+  out[n++] = static_cast<uint8_t>(value);
+  return n;
+}
+/// returns the number of bytes consumed, 0 for truncated or overlong input
+inline size_t decodeVarint(const uint8_t* in, size_t size, uint64_t& value) {
+  value = 0;
+  for (size_t n = 0; n != size && n != 10; n++) {
+    value |= uint64_t(in[n] & 0x7F) << (7 * n);
+    if (!(in[n] & 0x80)) {
+      return n + 1;
+    }
+  }
+  return 0;
+}
+/// the same bytes inside a bitstream
+template<typename Writer>
+void writeVarint(Writer& writer, uint64_t value) {
+  for (; value >= 0x80; value >>= 7) {
+    writer.writeBits(static_cast<uint32_t>(value | 0x80) & 0xFF, 8);
+  }
+  writer.writeBits(static_cast<uint32_t>(value), 8);
+}
+inline uint64_t readVarint(BitReader& reader) {
+  uint64_t value = 0;
+  for (uint32_t shift = 0; shift < 70; shift += 7) {
+    const uint32_t byte = reader.readBits(8);
+    value |= uint64_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+  return value;
+}
+
+/// Length-limited canonical Huffman codes. Decoding is a single lookup into a table of 2^maxCodeLength entries.
+/// Store getCodeLengths() next to the data to rebuild the same codec with fromCodeLengths().
+class HuffmanCodec {
+ public:
+  static constexpr uint32_t kMaxCodeLength = 16;
+
+  /// `frequencies[symbol]` == 0 - the symbol is never used
+  explicit HuffmanCodec(std::span<const uint32_t> frequencies, uint32_t maxCodeLength = 12);
+  static HuffmanCodec fromCodeLengths(std::span<const uint8_t> codeLengths);
+
+  template<typename Writer>
+  LFORCEINLINE void encode(Writer& writer, uint32_t symbol) const {
+    assert(lengths_[symbol]);
+    writer.writeBits(codes_[symbol], lengths_[symbol]);
+  }
+  LFORCEINLINE uint32_t decode(BitReader& reader) const {
+    const Entry e = table_[reader.peekBits(maxLength_)];
+    reader.consumeBits(e.length);
+    return e.symbol;
+  }
+  const std::vector<uint8_t>& getCodeLengths() const {
+    return lengths_;
+  }
+  /// canonical codes, the lowest getCodeLengths()[symbol] bits are used
+  const std::vector<uint32_t>& getCodes() const {
+    return codes_;
+  }
+  /// the number of bits needed to encode `frequencies`, excluding the code lengths
+  uint64_t getEncodedSize(std::span<const uint32_t> frequencies) const;
+
+ private:
+  HuffmanCodec() = default;
+  void buildCodes();
+
+ private:
+  struct Entry {
+    uint16_t symbol;
+    uint8_t length;
+  };
+  std::vector<uint32_t> codes_;
+  std::vector<uint8_t> lengths_;
+  std::vector<Entry> table_;
+  uint32_t maxLength_ = 0;
+};
+
+/// Byte-oriented rANS (32-bit states, byte-wise renormalization) over a static model of up to 256 byte symbols
+class RansModel {
+ public:
+  /// `frequencies` are scaled so that they sum to 2^scaleBits (8..15), every used symbol keeps a non-zero frequency
+  explicit RansModel(std::span<const uint32_t> frequencies, uint32_t scaleBits = 12);
+
+  uint32_t getScaleBits() const {
+    return scaleBits_;
+  }
+  /// normalized frequencies to be stored next to the data
+  const uint16_t* getFrequencies() const {
+    return freq_;
+  }
+  LFORCEINLINE uint32_t getFrequency(uint8_t symbol) const {
+    return freq_[symbol];
+  }
+  /// the sum of frequencies of all preceding symbols
+  LFORCEINLINE uint32_t getStart(uint8_t symbol) const {
+    return start_[symbol];
+  }
+  /// the symbol owning the slot in [0..2^scaleBits)
+  LFORCEINLINE uint8_t getSymbol(uint32_t slot) const {
+    return slots_[slot];
+  }
+
+ private:
+  uint32_t scaleBits_ = 0;
+  uint16_t freq_[256] = {};
+  uint16_t start_[256] = {};
+  // slot -> symbol
+  std::vector<uint8_t> slots_;
+};
+
+namespace detail {
+
+constexpr uint32_t kRansLowerBound = 1u << 23;
+
+} // namespace detail
+
+/// Encode `symbols` using NumStates interleaved rANS states: symbol i goes to the state i % NumStates,
+/// so independent states can be decoded in parallel by the CPU.
+template<uint32_t NumStates = 4>
+std::vector<uint8_t> ransEncode(std::span<const uint8_t> symbols, const RansModel& model) {
+  static_assert(NumStates > 0);
+
+  // rANS works as a stack: encode backwards writing bytes backwards, i.e. push them and reverse the result at the end
+  std::vector<uint8_t> out;
+  out.reserve(symbols.size() + 4 * NumStates + 16);
+
+  uint32_t states[NumStates];
+  for (uint32_t& x : states) {
+    x = detail::kRansLowerBound;
+  }
+
+  const uint32_t scaleBits = model.getScaleBits();
+
+  for (size_t i = symbols.size(); i-- > 0;) {
+    uint32_t& x = states[i % NumStates];
+    const uint32_t freq = model.getFrequency(symbols[i]);
+    assert(freq && "Symbol is not present in the model");
+    const uint32_t start = model.getStart(symbols[i]);
+    const uint32_t maxState = ((detail::kRansLowerBound >> scaleBits) << 8) * freq;
+    while (x >= maxState) {
+      out.push_back(static_cast<uint8_t>(x));
+      x >>= 8;
+    }
+    x = ((x / freq) << scaleBits) + (x % freq) + start;
+  }
+
+  // the decoder reads the states 0..NumStates-1 as little-endian words from the beginning
+  for (uint32_t s = NumStates; s-- > 0;) {
+    const uint32_t x = states[s];
+    out.push_back(static_cast<uint8_t>(x >> 24));
+    out.push_back(static_cast<uint8_t>(x >> 16));
+    out.push_back(static_cast<uint8_t>(x >> 8));
+    out.push_back(static_cast<uint8_t>(x));
+  }
+
+  std::reverse(out.begin(), out.end());
+
+  return out;
+}
+
+/// Decode `symbols.size()` symbols, returns false if `data` is too short
+template<uint32_t NumStates = 4>
+bool ransDecode(std::span<const uint8_t> data, std::span<uint8_t> symbols, const RansModel& model) {
+  static_assert(NumStates > 0);
+
+  if (data.size() < 4 * NumStates) {
+    return false;
+  }
+
+  const uint8_t* ptr = data.data();
+  const uint8_t* end = data.data() + data.size();
+
+  uint32_t states[NumStates];
+  for (uint32_t& x : states) {
+    x = uint32_t(ptr[0]) | (uint32_t(ptr[1]) << 8) | (uint32_t(ptr[2]) << 16) | (uint32_t(ptr[3]) << 24);
+    ptr += 4;
+  }
+
+  const uint32_t scaleBits = model.getScaleBits();
+  const uint32_t mask = (1u << scaleBits) - 1;
+
+  for (size_t i = 0; i < symbols.size(); i += NumStates) {
+    const size_t count = std::min<size_t>(NumStates, symbols.size() - i);
+    // independent states: the loop body has no dependencies between iterations
+    for (size_t s = 0; s != count; s++) {
+      uint32_t x = states[s];
+      const uint8_t sym = model.getSymbol(x & mask);
+      symbols[i + s] = sym;
+      x = model.getFrequency(sym) * (x >> scaleBits) + (x & mask) - model.getStart(sym);
+      while (x < detail::kRansLowerBound) {
+        if (ptr == end) {
+          return false;
+        }
+        x = (x << 8) | *ptr++;
+      }
+      states[s] = x;
+    }
+  }
+
+  return true;
+}
+
+} // namespace ldr
@@ -0,0 +1,123 @@
+﻿/**
+ * \file FileWatcher.cpp
+ * \brief
+ *
+ * Non-blocking notifications about file changes
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "FileWatcher.h"
+
+#include <stdio.h>
+
+// clang-format off
+#if defined(__linux__)
+#  include <errno.h>
+#  include <string.h>
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+// clang-format on
+
+ldr::FileWatcher::~FileWatcher() {
+  stop();
+}
+
+bool ldr::FileWatcher::watch(const char* fileName) {
+  stop();
+
+  const std::filesystem::path path = std::filesystem::absolute(fileName);
+
+#if defined(__linux__)
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if (fd_ < 0) {
+    printf("Failed to watch %s (%s)\n", fileName, strerror(errno));
+    return false;
+  }
+
+  // watch the directory: a file replaced by rename gets a new inode and a watch on the old one would go silent
+  wd_ = inotify_add_watch(fd_, path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+  if (wd_ < 0) {
+    printf("Failed to watch %s (%s)\n", fileName, strerror(errno));
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+#else
+  std::error_code ec;
+  lastWriteTime_ = std::filesystem::last_write_time(path, ec);
+  lastSize_ = std::filesystem::file_size(path, ec);
+
+  if (ec) {
+    printf("Failed to watch %s (%s)\n", fileName, ec.message().c_str());
+    return false;
+  }
+#endif
+
+  fileName_ = path;
+
+  return true;
+}
+
+void ldr::FileWatcher::stop() {
+#if defined(__linux__)
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  fd_ = -1;
+  wd_ = -1;
+#endif
+  fileName_.clear();
+}
+
+bool ldr::FileWatcher::poll() {
+  if (fileName_.empty()) {
+    return false;
+  }
+
+  bool changed = false;
+
+#if defined(__linux__)
+  const std::string name = fileName_.filename().string();
+
+  alignas(inotify_event) char buffer[4096];
+
+  for (;;) {
+    const ssize_t numBytes = ::read(fd_, buffer, sizeof(buffer));
+
+    if (numBytes <= 0) {
+      // EAGAIN: no more events
+      break;
+    }
+
+    for (ssize_t offset = 0; offset < numBytes;) {
+      const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      // a file written in place is reported once it is closed, not while it is half-written
+      if (event->len && name == event->name && (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))) {
+        changed = true;
+      }
+      offset += sizeof(inotify_event) + event->len;
+    }
+  }
+#else
+  std::error_code ec;
+  const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(fileName_, ec);
+  const uintmax_t size = std::filesystem::file_size(fileName_, ec);
+
+  // the file can be missing for a moment while it is being replaced
+  if (!ec && (writeTime != lastWriteTime_ || size != lastSize_)) {
+    lastWriteTime_ = writeTime;
+    lastSize_ = size;
+    changed = true;
+  }
+#endif
+
+  return changed;
+}
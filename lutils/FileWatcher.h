@@ -0,0 +1,50 @@
+﻿/**
+ * \file FileWatcher.h
+ * \brief
+ *
+ * Non-blocking notifications about file changes
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <stdint.h>
+#include <string>
+
+namespace ldr {
+
+/// Watch a single file. On Linux inotify watches the parent directory, so files replaced by rename (as linkers and editors do)
+/// are detected; other platforms compare the modification time and size on every poll().
+class FileWatcher {
+ public:
+  FileWatcher() = default;
+  ~FileWatcher();
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  bool watch(const char* fileName);
+  void stop();
+  /// returns true if the file was written, created or replaced since the previous call; never blocks
+  bool poll();
+  bool isWatching() const {
+    return !fileName_.empty();
+  }
+
+ private:
+  std::filesystem::path fileName_;
+#if defined(__linux__)
+  int fd_ = -1;
+  int wd_ = -1;
+#else
+  std::filesystem::file_time_type lastWriteTime_ = {};
+  uintmax_t lastSize_ = 0;
+#endif
+};
+
+} // namespace ldr
@@ -39,4 +39,8 @@
 #	define LMATH_USE_AVX2 1
 #endif // __AVX2__
 
+#if defined(__BMI2__)
+#	define LMATH_USE_BMI2 1
+#endif // __BMI2__
+
 // clang-format on
@@ -0,0 +1,198 @@
+/**
+ * \file MappedArray2D.h
+ * \brief
+ *
+ * Array2D backed by a memory-mapped file
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <optional>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+
+#include "Array2D.h"
+#include "MappedFile.h"
+
+namespace ldr {
+
+enum eArray2DFileLayout {
+  eArray2DFileLayout_Linear = 1,
+  eArray2DFileLayout_Tiled = 2,
+  eArray2DFileLayout_Morton = 3,
+};
+
+/// Stored at the beginning of the file, the elements follow at `dataOffset`
+struct Array2DFileHeader {
+  static constexpr uint32_t kMagic = 0x4432414C; // "LA2D"
+  static constexpr uint32_t kVersion = 2;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint64_t width = 0;
+  uint64_t height = 0;
+  /// number of elements allocated by the layout, including padding
+  uint64_t numElements = 0;
+  uint64_t dataOffset = 0;
+  uint32_t elementSize = 0;
+  /// application-defined element type identifier, checked on open
+  uint32_t elementType = 0;
+  /// eArray2DFileLayout and its parameters (see describeLayout()), checked on open
+  uint32_t layout = 0;
+  uint32_t layoutParams[2] = {};
+  uint32_t reserved = 0;
+};
+
+static_assert(sizeof(Array2DFileHeader) == 64);
+
+/// Fill in the layout fields of the header. Custom layouts can be stored by providing an overload in their own namespace.
+inline void describeLayout(const Array2DLinearLayout& layout, Array2DFileHeader& header) {
+  header.layout = eArray2DFileLayout_Linear;
+  header.layoutParams[0] = static_cast<uint32_t>(layout.getStride());
+  header.layoutParams[1] = 0;
+}
+template<size_t TileWidth, size_t TileHeight>
+void describeLayout(const Array2DTiledLayout<TileWidth, TileHeight>&, Array2DFileHeader& header) {
+  header.layout = eArray2DFileLayout_Tiled;
+  header.layoutParams[0] = static_cast<uint32_t>(TileWidth);
+  header.layoutParams[1] = static_cast<uint32_t>(TileHeight);
+}
+inline void describeLayout(const Array2DMortonLayout& layout, Array2DFileHeader& header) {
+  header.layout = eArray2DFileLayout_Morton;
+  header.layoutParams[0] = static_cast<uint32_t>(layout.getNumBitsX());
+  header.layoutParams[1] = static_cast<uint32_t>(layout.getNumBitsY());
+}
+
+/// A fixed-size container over a region of a mapped file: the Array2D storage. Writing into a read-only mapping will crash.
+template<typename T>
+class MappedContainer {
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be memory-mapped");
+
+ public:
+  typedef T value_type;
+
+  MappedContainer(MappedFile&& file, uint64_t offset, size_t size)
+  : file_(std::move(file)), data_(reinterpret_cast<T*>(file_.data() + offset)), size_(size) {}
+  MappedContainer(MappedContainer&&) = default;
+  MappedContainer& operator=(MappedContainer&&) = default;
+
+  LFORCEINLINE T& operator[](size_t i) {
+    return data_[i];
+  }
+  LFORCEINLINE const T& operator[](size_t i) const {
+    return data_[i];
+  }
+  LFORCEINLINE T* data() {
+    return data_;
+  }
+  LFORCEINLINE const T* data() const {
+    return data_;
+  }
+  LFORCEINLINE size_t size() const {
+    return size_;
+  }
+  bool flush() {
+    return file_.flush();
+  }
+  const MappedFile& getFile() const {
+    return file_;
+  }
+
+ private:
+  MappedFile file_;
+  T* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+template<typename T, typename Layout = Array2DLinearLayout>
+using MappedArray2D = Array2D<MappedContainer<T>, Layout>;
+
+/// Create a new zero-filled grid file. Only the header is written, the data pages are allocated by the OS on first write.
+template<typename T, typename Layout = Array2DLinearLayout>
+std::optional<MappedArray2D<T, Layout>> createMappedArray2D(const char* fileName, size_t w, size_t h, uint32_t elementType = 0) {
+  const Layout layout(w, h);
+
+  Array2DFileHeader header;
+  header.width = w;
+  header.height = h;
+  header.numElements = layout.getSize();
+  header.dataOffset = std::max<uint64_t>(64, alignof(T));
+  header.elementSize = sizeof(T);
+  header.elementType = elementType;
+  describeLayout(layout, header);
+
+  if (header.numElements > (UINT64_MAX - header.dataOffset) / sizeof(T)) {
+    printf("%s: %zux%zu grid is too large\n", fileName, w, h);
+    return std::nullopt;
+  }
+
+  MappedFile file;
+
+  if (!file.create(fileName, header.dataOffset + header.numElements * sizeof(T))) {
+    return std::nullopt;
+  }
+
+  memcpy(file.data(), &header, sizeof(header));
+
+  return MappedArray2D<T, Layout>(w, h, layout, MappedContainer<T>(std::move(file), header.dataOffset, layout.getSize()));
+}
+
+/// Open an existing grid file created by createMappedArray2D() with the same T, Layout and `elementType`
+template<typename T, typename Layout = Array2DLinearLayout>
+std::optional<MappedArray2D<T, Layout>> openMappedArray2D(const char* fileName, eMappedFileMode mode, uint32_t elementType = 0) {
+  MappedFile file;
+
+  if (!file.open(fileName, mode)) {
+    return std::nullopt;
+  }
+
+  Array2DFileHeader header;
+
+  if (file.size() < sizeof(header)) {
+    printf("%s is not an Array2D file\n", fileName);
+    return std::nullopt;
+  }
+
+  memcpy(&header, file.data(), sizeof(header));
+
+  if (header.magic != Array2DFileHeader::kMagic || header.version != Array2DFileHeader::kVersion) {
+    printf("%s is not an Array2D file\n", fileName);
+    return std::nullopt;
+  }
+  if (header.elementSize != sizeof(T) || header.elementType != elementType) {
+    printf("%s: element type mismatch (size %u, type %u)\n", fileName, header.elementSize, header.elementType);
+    return std::nullopt;
+  }
+
+  const Layout layout(static_cast<size_t>(header.width), static_cast<size_t>(header.height));
+
+  Array2DFileHeader expected;
+  describeLayout(layout, expected);
+
+  if (header.layout != expected.layout || header.layoutParams[0] != expected.layoutParams[0] ||
+      header.layoutParams[1] != expected.layoutParams[1] || header.numElements != layout.getSize()) {
+    printf("%s: layout mismatch (layout %u, parameters %u, %u)\n", fileName, header.layout, header.layoutParams[0], header.layoutParams[1]);
+    return std::nullopt;
+  }
+  // no overflow: dataOffset <= size is checked first
+  if (header.dataOffset < sizeof(header) || header.dataOffset % alignof(T) || header.dataOffset > file.size() ||
+      header.numElements > (file.size() - header.dataOffset) / sizeof(T)) {
+    printf("%s: truncated file\n", fileName);
+    return std::nullopt;
+  }
+
+  return MappedArray2D<T, Layout>(static_cast<size_t>(header.width),
+                                  static_cast<size_t>(header.height),
+                                  layout,
+                                  MappedContainer<T>(std::move(file), header.dataOffset, layout.getSize()));
+}
+
+} // namespace ldr
@@ -0,0 +1,204 @@
+﻿/**
+ * \file MappedFile.cpp
+ * \brief
+ *
+ * Cross-platform memory-mapped files
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "MappedFile.h"
+
+#include <stdio.h>
+#include <utility>
+
+// clang-format off
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <winioctl.h>
+#else
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <string.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+// clang-format on
+
+ldr::MappedFile::~MappedFile() {
+  close();
+}
+
+ldr::MappedFile::MappedFile(MappedFile&& other) noexcept
+: data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)), mode_(other.mode_) {}
+
+ldr::MappedFile& ldr::MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mode_ = other.mode_;
+  }
+  return *this;
+}
+
+bool ldr::MappedFile::open(const char* fileName, eMappedFileMode mode) {
+  return map(fileName, mode, 0);
+}
+
+bool ldr::MappedFile::create(const char* fileName, uint64_t size) {
+  if (!size) {
+    printf("Cannot create an empty mapped file %s\n", fileName);
+    return false;
+  }
+  return map(fileName, eMappedFileMode_ReadWrite, size);
+}
+
+// `newSize` != 0 creates a new file of this size
+bool ldr::MappedFile::map(const char* fileName, eMappedFileMode mode, uint64_t newSize) {
+  close();
+
+  const bool writable = mode == eMappedFileMode_ReadWrite;
+
+#if defined(_WIN32)
+  HANDLE file = ::CreateFileA(fileName,
+                              writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              newSize ? CREATE_ALWAYS : OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+  if (file == INVALID_HANDLE_VALUE) {
+    printf("Failed to open %s (error %lu)\n", fileName, ::GetLastError());
+    return false;
+  }
+
+  LARGE_INTEGER size = {};
+
+  if (newSize) {
+    DWORD bytes = 0;
+    // sparse files are allocated on first write
+    ::DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes, nullptr);
+    size.QuadPart = static_cast<LONGLONG>(newSize);
+    if (!::SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !::SetEndOfFile(file)) {
+      printf("Failed to resize %s (error %lu)\n", fileName, ::GetLastError());
+      ::CloseHandle(file);
+      return false;
+    }
+  } else if (!::GetFileSizeEx(file, &size)) {
+    printf("Failed to get the size of %s (error %lu)\n", fileName, ::GetLastError());
+    ::CloseHandle(file);
+    return false;
+  }
+
+  if (!size.QuadPart) {
+    printf("Cannot map an empty file %s\n", fileName);
+    ::CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = ::CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+
+  ::CloseHandle(file);
+
+  if (!mapping) {
+    printf("Failed to map %s (error %lu)\n", fileName, ::GetLastError());
+    return false;
+  }
+
+  void* ptr = ::MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+
+  // the view keeps the mapping alive
+  ::CloseHandle(mapping);
+
+  if (!ptr) {
+    printf("Failed to map %s (error %lu)\n", fileName, ::GetLastError());
+    return false;
+  }
+
+  data_ = ptr;
+  size_ = static_cast<uint64_t>(size.QuadPart);
+#else
+  const int flags = writable ? (newSize ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR) : O_RDONLY;
+
+  const int fd = ::open(fileName, flags, 0644);
+
+  if (fd < 0) {
+    printf("Failed to open %s (%s)\n", fileName, strerror(errno));
+    return false;
+  }
+
+  uint64_t size = newSize;
+
+  if (newSize) {
+    // leaves a hole which the file system allocates on first write
+    if (::ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+      printf("Failed to resize %s (%s)\n", fileName, strerror(errno));
+      ::close(fd);
+      return false;
+    }
+  } else {
+    struct stat st = {};
+    if (::fstat(fd, &st) != 0) {
+      printf("Failed to get the size of %s (%s)\n", fileName, strerror(errno));
+      ::close(fd);
+      return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+  }
+
+  if (!size) {
+    printf("Cannot map an empty file %s\n", fileName);
+    ::close(fd);
+    return false;
+  }
+
+  void* ptr = ::mmap(nullptr, static_cast<size_t>(size), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+
+  // the mapping keeps the file alive
+  ::close(fd);
+
+  if (ptr == MAP_FAILED) {
+    printf("Failed to map %s (%s)\n", fileName, strerror(errno));
+    return false;
+  }
+
+  data_ = ptr;
+  size_ = size;
+#endif
+
+  mode_ = mode;
+
+  return true;
+}
+
+void ldr::MappedFile::close() {
+  if (!data_) {
+    return;
+  }
+#if defined(_WIN32)
+  ::UnmapViewOfFile(data_);
+#else
+  ::munmap(data_, static_cast<size_t>(size_));
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool ldr::MappedFile::flush() {
+  if (!data_ || !isWritable()) {
+    return false;
+  }
+#if defined(_WIN32)
+  return ::FlushViewOfFile(data_, 0) != 0;
+#else
+  return ::msync(data_, static_cast<size_t>(size_), MS_SYNC) == 0;
+#endif
+}
@@ -0,0 +1,64 @@
+﻿/**
+ * \file MappedFile.h
+ * \brief
+ *
+ * Cross-platform memory-mapped files
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace ldr {
+
+enum eMappedFileMode {
+  eMappedFileMode_ReadOnly,
+  eMappedFileMode_ReadWrite,
+};
+
+/// The whole file is mapped into the address space, pages are read from disk on first access
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  bool open(const char* fileName, eMappedFileMode mode);
+  /// create (or truncate) a read-write file of `size` bytes; the new space is zero-filled lazily by the OS (sparse where supported)
+  bool create(const char* fileName, uint64_t size);
+  void close();
+  /// write dirty pages back to disk
+  bool flush();
+
+  bool isOpen() const {
+    return data_ != nullptr;
+  }
+  bool isWritable() const {
+    return mode_ == eMappedFileMode_ReadWrite;
+  }
+  uint8_t* data() const {
+    return static_cast<uint8_t*>(data_);
+  }
+  uint64_t size() const {
+    return size_;
+  }
+
+ private:
+  bool map(const char* fileName, eMappedFileMode mode, uint64_t newSize);
+
+ private:
+  void* data_ = nullptr;
+  uint64_t size_ = 0;
+  eMappedFileMode mode_ = eMappedFileMode_ReadOnly;
+};
+
+} // namespace ldr
@@ -0,0 +1,183 @@
+/**
+ * \file PoolAllocator.h
+ * \brief
+ *
+ * Fixed-size block pool with thread-local free lists
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace ldr {
+
+/// Fixed-size blocks carved from large slabs. Every thread allocates from and frees into its own free list
+/// without any synchronization; surplus blocks are handed over to a shared list in batches. Slabs are never
+/// returned to the system.
+template<size_t BlockSize, size_t Alignment>
+class FixedBlockPool final {
+  struct Node {
+    Node* next;
+  };
+
+ public:
+  static constexpr size_t kAlignment = Alignment > alignof(Node) ? Alignment : alignof(Node);
+  static constexpr size_t kBlockSize = ((BlockSize > sizeof(Node) ? BlockSize : sizeof(Node)) + kAlignment - 1) & ~(kAlignment - 1);
+  static constexpr size_t kBlocksPerSlab = kBlockSize < 1024 ? 65536 / kBlockSize : 64;
+  static constexpr size_t kBatchSize = kBlocksPerSlab < 256 ? kBlocksPerSlab : 256;
+
+  static void* allocate() {
+    LocalCache& cache = local();
+    if (!cache.freeList) {
+      refill(cache);
+    }
+    Node* node = cache.freeList;
+    cache.freeList = node->next;
+    cache.numFree--;
+    if (cache.isTornDown) {
+      // during thread exit every block goes straight through the shared list
+      cache.giveBack(0, cache.numFree);
+    }
+    return node;
+  }
+  static void deallocate(void* p) {
+    assert(p);
+    LocalCache& cache = local();
+    Node* node = static_cast<Node*>(p);
+    node->next = cache.freeList;
+    cache.freeList = node;
+    if (cache.isTornDown) {
+      cache.giveBack(0, ++cache.numFree);
+    } else if (++cache.numFree > kMaxLocalBlocks) {
+      // keep the recently freed (cache-hot) blocks and give away the ones behind them
+      cache.giveBack(kBatchSize, kBatchSize);
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxLocalBlocks = kBlocksPerSlab + kBatchSize;
+
+  struct SharedList {
+    std::mutex mutex;
+    Node* freeList = nullptr;
+  };
+  // trivially destructible: it stays usable when other thread_local destructors free pooled objects during thread exit
+  struct LocalCache {
+    Node* freeList = nullptr;
+    size_t numFree = 0;
+    bool isTornDown = false;
+    // move `count` blocks following the first `skip` blocks of the local list to the shared list
+    void giveBack(size_t skip, size_t count) {
+      assert(skip + count <= numFree);
+      if (!count) {
+        return;
+      }
+      Node** link = &freeList;
+      for (size_t i = 0; i != skip; i++) {
+        link = &(*link)->next;
+      }
+      Node* head = *link;
+      Node* tail = head;
+      for (size_t i = 1; i != count; i++) {
+        tail = tail->next;
+      }
+      *link = tail->next;
+      numFree -= count;
+      SharedList& s = shared();
+      std::lock_guard lock(s.mutex);
+      tail->next = s.freeList;
+      s.freeList = head;
+    }
+  };
+
+  static SharedList& shared() {
+    static SharedList list;
+    return list;
+  }
+  // hands the local blocks over to the shared list when the thread exits
+  struct LocalCacheOwner {
+    LocalCache& cache;
+    ~LocalCacheOwner() {
+      cache.giveBack(0, cache.numFree);
+      cache.isTornDown = true;
+    }
+  };
+
+  static LocalCache& local() {
+    thread_local LocalCache cache;
+    thread_local LocalCacheOwner owner{cache};
+    (void)owner;
+    return cache;
+  }
+  static void refill(LocalCache& cache) {
+    assert(!cache.freeList);
+    {
+      SharedList& s = shared();
+      std::lock_guard lock(s.mutex);
+      if (s.freeList) {
+        Node* head = s.freeList;
+        Node* tail = head;
+        size_t count = 1;
+        while (count != kBatchSize && tail->next) {
+          tail = tail->next;
+          count++;
+        }
+        s.freeList = tail->next;
+        tail->next = nullptr;
+        cache.freeList = head;
+        cache.numFree = count;
+        return;
+      }
+    }
+    uint8_t* slab = static_cast<uint8_t*>(::operator new(kBlocksPerSlab * kBlockSize, std::align_val_t(kAlignment)));
+    for (size_t i = kBlocksPerSlab; i-- > 0;) {
+      Node* node = reinterpret_cast<Node*>(slab + i * kBlockSize);
+      node->next = cache.freeList;
+      cache.freeList = node;
+    }
+    cache.numFree = kBlocksPerSlab;
+  }
+};
+
+/// std-compatible allocator which serves single-object allocations from FixedBlockPool
+template<class T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template<class U>
+  PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+  [[nodiscard]] T* allocate(size_t n) {
+    if (n == 1) {
+      return static_cast<T*>(FixedBlockPool<sizeof(T), alignof(T)>::allocate());
+    }
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) {
+    if (n == 1) {
+      FixedBlockPool<sizeof(T), alignof(T)>::deallocate(p);
+    } else {
+      std::allocator<T>().deallocate(p, n);
+    }
+  }
+
+  template<class U>
+  bool operator==(const PoolAllocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+} // namespace ldr
@@ -0,0 +1,371 @@
+/**
+ * \file Profiler.cpp
+ * \brief
+ *
+ * PROFILE_SCOPE instrumentation with per-thread ring buffers
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+
+#include "EntropyCoding.h"
+
+namespace {
+
+constexpr uint32_t kBinaryMagic = 0x4650524C; // "LPRF"
+constexpr uint32_t kBinaryVersion = 1;
+
+uint64_t steadyNs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct ProfilerRegistry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ldr::detail::ProfilerThreadBuffer>> buffers;
+  uint32_t nextThreadIndex = 0;
+  // the reference point of all timestamps, also used to calibrate rdtsc against steady_clock
+  const uint64_t startTicks = ldr::Profiler::now();
+  const uint64_t startNs = steadyNs();
+};
+
+ProfilerRegistry& getRegistry() {
+  // never destroyed: threads can record events during static destruction
+  static ProfilerRegistry* registry = new ProfilerRegistry;
+  return *registry;
+}
+
+// construct the registry during static initialization so the time origin is the process start
+const ProfilerRegistry& registryInit = getRegistry();
+
+double getNsPerTick(const ProfilerRegistry& registry) {
+#if defined(LDR_PROFILER_USE_RDTSC)
+  // the longer the process runs, the more precise the calibration gets; a freshly started one has to wait a bit
+  uint64_t ns = steadyNs();
+  while (ns - registry.startNs < 1000000) {
+    ns = steadyNs();
+  }
+  const uint64_t ticks = ldr::Profiler::now();
+  return double(ns - registry.startNs) / double(ticks - registry.startTicks);
+#else
+  (void)registry;
+  return 1.0;
+#endif
+}
+
+void writeEscapedString(FILE* file, const std::string& str) {
+  fputc('"', file);
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      fputc('\\', file);
+      fputc(c, file);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      fprintf(file, "\\u%04x", static_cast<unsigned char>(c));
+    } else {
+      fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+void appendVarint(std::vector<uint8_t>& out, uint64_t value) {
+  uint8_t bytes[10];
+  out.insert(out.end(), bytes, bytes + ldr::encodeVarint(value, bytes));
+}
+
+} // namespace
+
+struct ldr::Profiler::ThreadBufferOwner {
+  detail::ProfilerThreadBuffer* buffer = nullptr;
+
+  ~ThreadBufferOwner() {
+    isOwnerDestroyed_ = true;
+    if (!buffer) {
+      return;
+    }
+    // events recorded after this point (from other thread_local destructors) go to a new buffer
+    threadBuffer_ = nullptr;
+    // the registry owns the buffer: keep it for capture() and let reset() free it
+    std::lock_guard lock(getRegistry().mutex);
+    buffer->isOrphaned.store(true, std::memory_order_release);
+  }
+};
+
+thread_local ldr::Profiler::ThreadBufferOwner ldr::Profiler::threadBufferOwner_;
+
+ldr::detail::ProfilerThreadBuffer* ldr::Profiler::registerThread() {
+  ProfilerRegistry& registry = getRegistry();
+
+  std::lock_guard lock(registry.mutex);
+
+  registry.buffers.push_back(std::make_unique<detail::ProfilerThreadBuffer>());
+  detail::ProfilerThreadBuffer* buffer = registry.buffers.back().get();
+  buffer->threadIndex = registry.nextThreadIndex++;
+
+  threadBuffer_ = buffer;
+
+  if (isOwnerDestroyed_) {
+    // recorded from a thread_local destructor which runs after the owner's one: nothing will orphan this buffer later
+    buffer->isOrphaned.store(true, std::memory_order_release);
+  } else {
+    threadBufferOwner_.buffer = buffer;
+  }
+
+  return buffer;
+}
+
+ldr::ProfileCapture ldr::Profiler::capture() {
+  ProfilerRegistry& registry = getRegistry();
+
+  const double nsPerTick = getNsPerTick(registry);
+
+  ProfileCapture capture;
+
+  // string literals are deduplicated by address first, by contents across translation units
+  std::unordered_map<const char*, uint32_t> namePtrs;
+  std::unordered_map<std::string, uint32_t> nameStrings;
+
+  struct Event {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  std::vector<Event> events;
+
+  std::lock_guard lock(registry.mutex);
+
+  for (const std::unique_ptr<detail::ProfilerThreadBuffer>& buffer : registry.buffers) {
+    constexpr uint64_t kCapacity = detail::ProfilerThreadBuffer::kCapacity;
+
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    const uint64_t first = head > kCapacity ? head - kCapacity : 0;
+
+    events.resize(head - first);
+    for (uint64_t i = first; i != head; i++) {
+      const detail::ProfilerThreadBuffer::Event& e = buffer->events[i & (kCapacity - 1)];
+      events[i - first] = {
+          e.name.load(std::memory_order_relaxed),
+          e.start.load(std::memory_order_relaxed),
+          e.end.load(std::memory_order_relaxed),
+      };
+    }
+
+    // The owning thread kept recording while we were copying. A slot holding event `j` is written only after head == j
+    // was stored (see the fence in record()), so the fence below guarantees `newHead` covers every overwrite we could
+    // have seen: drop the events whose slots were reused, including the one which may be in flight.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t newHead = buffer->head.load(std::memory_order_relaxed);
+    const uint64_t firstValid = std::max(first, newHead >= kCapacity ? newHead - kCapacity + 1 : 0);
+
+    for (uint64_t i = std::min(firstValid, head); i != head; i++) {
+      const Event& e = events[i - first];
+
+      auto [it, isNewPtr] = namePtrs.try_emplace(e.name, 0);
+      if (isNewPtr) {
+        auto [itStr, isNewStr] = nameStrings.try_emplace(e.name, static_cast<uint32_t>(capture.names.size()));
+        if (isNewStr) {
+          capture.names.emplace_back(e.name);
+        }
+        it->second = itStr->second;
+      }
+
+      // events recorded before the registry was initialized are clamped to the time origin
+      const uint64_t start = e.start > registry.startTicks ? e.start - registry.startTicks : 0;
+      const uint64_t end = e.end > e.start ? e.end - e.start : 0;
+
+      capture.events.push_back({
+          .nameIndex = it->second,
+          .threadIndex = buffer->threadIndex,
+          .startNs = static_cast<uint64_t>(double(start) * nsPerTick),
+          .durationNs = static_cast<uint64_t>(double(end) * nsPerTick),
+      });
+    }
+  }
+
+  std::stable_sort(capture.events.begin(), capture.events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+    return a.startNs < b.startNs;
+  });
+
+  return capture;
+}
+
+void ldr::Profiler::reset() {
+  ProfilerRegistry& registry = getRegistry();
+
+  std::lock_guard lock(registry.mutex);
+
+  std::erase_if(registry.buffers, [](const std::unique_ptr<detail::ProfilerThreadBuffer>& buffer) {
+    return buffer->isOrphaned.load(std::memory_order_acquire);
+  });
+
+  for (const std::unique_ptr<detail::ProfilerThreadBuffer>& buffer : registry.buffers) {
+    buffer->head.store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t ldr::Profiler::getNumThreadBuffers() {
+  ProfilerRegistry& registry = getRegistry();
+
+  std::lock_guard lock(registry.mutex);
+
+  return registry.buffers.size();
+}
+
+bool ldr::ProfileCapture::saveChromeTrace(const char* fileName) const {
+  FILE* file = fopen(fileName, "wb");
+
+  if (!file) {
+    printf("Cannot write profile to %s\n", fileName);
+    return false;
+  }
+
+  fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+  for (size_t i = 0; i != events.size(); i++) {
+    const ProfileEvent& e = events[i];
+    fprintf(file, "{\"name\":");
+    writeEscapedString(file, e.nameIndex < names.size() ? names[e.nameIndex] : std::string());
+    fprintf(file,
+            ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+            e.threadIndex,
+            double(e.startNs) * 0.001,
+            double(e.durationNs) * 0.001,
+            i + 1 != events.size() ? "," : "");
+  }
+
+  fprintf(file, "]}\n");
+
+  const bool success = !ferror(file);
+
+  fclose(file);
+
+  if (!success) {
+    printf("Cannot write profile to %s\n", fileName);
+  }
+
+  return success;
+}
+
+std::vector<uint8_t> ldr::ProfileCapture::toBinary() const {
+  std::vector<uint8_t> out;
+
+  appendVarint(out, kBinaryMagic);
+  appendVarint(out, kBinaryVersion);
+  appendVarint(out, names.size());
+
+  for (const std::string& name : names) {
+    appendVarint(out, name.size());
+    out.insert(out.end(), name.begin(), name.end());
+  }
+
+  appendVarint(out, events.size());
+
+  uint64_t prevStart = 0;
+
+  for (const ProfileEvent& e : events) {
+    appendVarint(out, e.threadIndex);
+    appendVarint(out, e.nameIndex);
+    // capture() sorts events by the start time, so deltas are small; zigzag keeps unsorted captures encodable
+    appendVarint(out, zigZagEncode(static_cast<int64_t>(e.startNs - prevStart)));
+    appendVarint(out, e.durationNs);
+    prevStart = e.startNs;
+  }
+
+  return out;
+}
+
+bool ldr::ProfileCapture::saveBinary(const char* fileName) const {
+  const std::vector<uint8_t> data = toBinary();
+
+  FILE* file = fopen(fileName, "wb");
+
+  const bool success = file && fwrite(data.data(), data.size(), 1, file) == 1;
+
+  if (file) {
+    fclose(file);
+  }
+
+  if (!success) {
+    printf("Cannot write profile to %s\n", fileName);
+  }
+
+  return success;
+}
+
+bool ldr::ProfileCapture::fromBinary(std::span<const uint8_t> data) {
+  names.clear();
+  events.clear();
+
+  size_t offset = 0;
+
+  auto read = [&data, &offset](uint64_t& value) -> bool {
+    const size_t n = decodeVarint(data.data() + offset, data.size() - offset, value);
+    offset += n;
+    return n != 0;
+  };
+
+  uint64_t magic = 0;
+  uint64_t version = 0;
+  uint64_t numNames = 0;
+
+  if (!read(magic) || magic != kBinaryMagic || !read(version) || version > kBinaryVersion || !read(numNames)) {
+    printf("Not a binary profile\n");
+    return false;
+  }
+
+  for (uint64_t i = 0; i != numNames; i++) {
+    uint64_t length = 0;
+    if (!read(length) || length > data.size() - offset) {
+      printf("Binary profile is truncated\n");
+      return false;
+    }
+    names.emplace_back(reinterpret_cast<const char*>(data.data() + offset), static_cast<size_t>(length));
+    offset += static_cast<size_t>(length);
+  }
+
+  uint64_t numEvents = 0;
+
+  if (!read(numEvents)) {
+    printf("Binary profile is truncated\n");
+    return false;
+  }
+
+  uint64_t start = 0;
+
+  for (uint64_t i = 0; i != numEvents; i++) {
+    uint64_t threadIndex = 0;
+    uint64_t nameIndex = 0;
+    uint64_t startDelta = 0;
+    uint64_t duration = 0;
+    if (!read(threadIndex) || !read(nameIndex) || !read(startDelta) || !read(duration)) {
+      printf("Binary profile is truncated\n");
+      return false;
+    }
+    if (nameIndex >= names.size()) {
+      printf("Binary profile is corrupted\n");
+      return false;
+    }
+    start += static_cast<uint64_t>(zigZagDecode(startDelta));
+    events.push_back({
+        .nameIndex = static_cast<uint32_t>(nameIndex),
+        .threadIndex = static_cast<uint32_t>(threadIndex),
+        .startNs = start,
+        .durationNs = duration,
+    });
+  }
+
+  return true;
+}
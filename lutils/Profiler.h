@@ -0,0 +1,144 @@
+/**
+ * \file Profiler.h
+ * \brief
+ *
+ * PROFILE_SCOPE instrumentation with per-thread ring buffers
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <atomic>
+#include <span>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// clang-format off
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#  define LDR_PROFILER_USE_RDTSC 1
+#else
+#  include <chrono>
+#endif
+// clang-format on
+
+#include "Macros.h"
+#include "ScopeExit.h"
+
+namespace ldr {
+
+struct ProfileEvent {
+  uint32_t nameIndex = 0;
+  uint32_t threadIndex = 0;
+  uint64_t startNs = 0;
+  uint64_t durationNs = 0;
+};
+
+/// A snapshot of recorded events, sorted by the start time. Timestamps are relative to the process start.
+struct ProfileCapture {
+  std::vector<std::string> names;
+  std::vector<ProfileEvent> events;
+
+  /// chrome://tracing and Perfetto "X" (complete) events
+  bool saveChromeTrace(const char* fileName) const;
+  /// LEB128 varints, start times are delta-encoded
+  bool saveBinary(const char* fileName) const;
+  std::vector<uint8_t> toBinary() const;
+  bool fromBinary(std::span<const uint8_t> data);
+};
+
+namespace detail {
+
+struct ProfilerThreadBuffer {
+  /// the oldest events are overwritten
+  static constexpr uint32_t kCapacity = 1u << 16;
+
+  /// relaxed atomics: capture() reads the slots while the owning thread overwrites them
+  struct Event {
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> end;
+  };
+
+  uint32_t threadIndex = 0;
+  /// set when the owning thread exits, reset() frees such buffers
+  std::atomic<bool> isOrphaned = false;
+  /// the total number of events ever recorded: written only by the owning thread
+  std::atomic<uint64_t> head = 0;
+  Event events[kCapacity] = {};
+};
+
+} // namespace detail
+
+/// Recording costs two timestamps and a few relaxed stores into a buffer owned by the current thread, no locks or atomic RMW.
+/// Threads register their buffers (~1.5 MB each) on the first event. Buffers of exited threads are kept for capture() until
+/// the next reset(), so programs with short-lived recording threads should call reset() periodically.
+class Profiler final {
+ public:
+  /// CPU ticks (rdtsc on x86, steady_clock nanoseconds elsewhere), converted to nanoseconds by capture()
+  static LFORCEINLINE uint64_t now() {
+#if defined(LDR_PROFILER_USE_RDTSC)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+  }
+  /// `name` should outlive the profiler, i.e. be a string literal
+  static LFORCEINLINE void record(const char* name, uint64_t start, uint64_t end) {
+    detail::ProfilerThreadBuffer* buffer = threadBuffer_;
+    if (!buffer) [[unlikely]] {
+      buffer = registerThread();
+    }
+    const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    // order the previous head.store() before the slot stores: capture() relies on it to detect overwritten slots
+    std::atomic_thread_fence(std::memory_order_release);
+    detail::ProfilerThreadBuffer::Event& e = buffer->events[head & (detail::ProfilerThreadBuffer::kCapacity - 1)];
+    e.name.store(name, std::memory_order_relaxed);
+    e.start.store(start, std::memory_order_relaxed);
+    e.end.store(end, std::memory_order_relaxed);
+    // publish the event to capture()
+    buffer->head.store(head + 1, std::memory_order_release);
+  }
+  /// Can run while other threads are recording: events overwritten during the capture are dropped
+  static ProfileCapture capture();
+  /// Drop all events and free the buffers of exited threads. Should not run concurrently with recording threads.
+  static void reset();
+  /// the number of registered buffers, including the ones of exited threads not yet freed by reset()
+  static size_t getNumThreadBuffers();
+
+ private:
+  struct ThreadBufferOwner;
+
+  static detail::ProfilerThreadBuffer* registerThread();
+  static inline thread_local detail::ProfilerThreadBuffer* threadBuffer_ = nullptr;
+  // trivially destructible, so it can be read from thread_local destructors which run after threadBufferOwner_ is gone
+  static inline thread_local bool isOwnerDestroyed_ = false;
+  // has a destructor, so it is kept out of the record() path
+  static thread_local ThreadBufferOwner threadBufferOwner_;
+};
+
+} // namespace ldr
+
+/// Define LMATH_ENABLE_PROFILING (the CMake option of the same name) to record scopes, otherwise PROFILE_SCOPE() compiles to nothing
+// clang-format off
+#if defined(LMATH_ENABLE_PROFILING)
+#  define PROFILE_SCOPE(name)                                                              \
+     const uint64_t LDR_CONCATENATE(profileScopeStart, __LINE__) = ldr::Profiler::now(); \
+     SCOPE_EXIT {                                                                          \
+       ldr::Profiler::record(name, LDR_CONCATENATE(profileScopeStart, __LINE__), ldr::Profiler::now()); \
+     }
+#else
+#  define PROFILE_SCOPE(name)
+#endif // LMATH_ENABLE_PROFILING
+// clang-format on
@@ -1,59 +1,231 @@
-﻿/**
+/**
  * \file ptr.cpp
  * \brief
  *
  * Minimalistic intrusive smartpointer
  *
- * \version 1.0.0
- * \date 16/09/2022
- * \author Sergey Kosarevsky, 2022
+ * \version 1.1.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2022-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
  */
 
 #include "Ptr.h"
 
-#include <assert.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 // clang-format off
-#if defined(_MSC_VER)
-#	define WIN32_LEAN_AND_MEAN
-#	define VC_EXTRALEAN
-#	define NOMINMAX
-#	include <windows.h>
-#endif // _MSC_VER
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  include <immintrin.h>
+#  define LDR_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#  define LDR_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#  define LDR_CPU_RELAX()
+#endif
 // clang-format on
 
+namespace {
+
+// object address -> control block; only weakly referenced objects ever get here
+struct WeakControlBlockTable {
+  std::mutex mutex;
+  std::unordered_map<const void*, ldr::WeakControlBlock*> blocks;
+};
+
+WeakControlBlockTable& getTable() {
+  static WeakControlBlockTable* table = new WeakControlBlockTable(); // never destroyed: objects can outlive static destructors
+  return *table;
+}
+
+struct RetiredBatch {
+  static constexpr size_t kCapacity = 64;
+  RetiredBatch* next = nullptr;
+  size_t count = 0;
+  void* objects[kCapacity];
+  ldr::DeferredReclamation::DestroyFunc destroy[kCapacity];
+};
+
+// lock-free stack of retired batches: pushed by any thread, taken all at once by collect()
+std::atomic<RetiredBatch*> retiredBatches = nullptr;
+
+void pushRetiredBatch(RetiredBatch* batch) {
+  batch->next = retiredBatches.load(std::memory_order_relaxed);
+  while (!retiredBatches.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {
+  }
+}
+
+struct LocalRetiredBatch {
+  RetiredBatch* batch = nullptr;
+  ~LocalRetiredBatch() {
+    if (batch)
+      pushRetiredBatch(batch);
+  }
+};
+
+thread_local LocalRetiredBatch localBatch;
+
+struct BackgroundReclaimer {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::thread thread;
+  bool stop = false;
+  // the program can exit without stopBackgroundThread()
+  ~BackgroundReclaimer() {
+    stopThread();
+  }
+  void stopThread() {
+    if (!thread.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard lock(mutex);
+      stop = true;
+    }
+    cv.notify_one();
+    thread.join();
+  }
+};
+
+BackgroundReclaimer& getReclaimer() {
+  static BackgroundReclaimer reclaimer;
+  return reclaimer;
+}
+
+} // namespace
+
+void ldr::DeferredReclamation::retire(void* object, DestroyFunc destroy) {
+  RetiredBatch*& batch = localBatch.batch;
+
+  if (!batch) {
+    batch = new RetiredBatch();
+  }
+
+  batch->objects[batch->count] = object;
+  batch->destroy[batch->count] = destroy;
+
+  if (++batch->count == RetiredBatch::kCapacity) {
+    pushRetiredBatch(batch);
+    batch = nullptr;
+  }
+}
+
+void ldr::DeferredReclamation::flush() {
+  if (localBatch.batch) {
+    pushRetiredBatch(localBatch.batch);
+    localBatch.batch = nullptr;
+  }
+}
+
+size_t ldr::DeferredReclamation::collect() {
+  flush();
+
+  RetiredBatch* batch = retiredBatches.exchange(nullptr, std::memory_order_acquire);
+
+  size_t numDestroyed = 0;
+
+  while (batch) {
+    // destructors can retire more objects: they go to this thread's local batch
+    for (size_t i = 0; i != batch->count; i++) {
+      batch->destroy[i](batch->objects[i]);
+    }
+    numDestroyed += batch->count;
+    RetiredBatch* next = batch->next;
+    delete batch;
+    batch = next;
+  }
+
+  return numDestroyed;
+}
+
+void ldr::DeferredReclamation::startBackgroundThread(uint32_t periodMs) {
+  BackgroundReclaimer& r = getReclaimer();
+
+  assert(!r.thread.joinable());
+
+  r.stop = false;
+  r.thread = std::thread([&r, periodMs]() {
+    std::unique_lock lock(r.mutex);
+    while (!r.stop) {
+      r.cv.wait_for(lock, std::chrono::milliseconds(periodMs), [&r]() { return r.stop; });
+      lock.unlock();
+      DeferredReclamation::collect();
+      lock.lock();
+    }
+  });
+}
+
+void ldr::DeferredReclamation::stopBackgroundThread() {
+  getReclaimer().stopThread();
+}
+
 void ldr::IntrusiveCounter::incRef(void* p) {
   if (p) {
-    reinterpret_cast<ldr::IntrusiveCounter*>(p)->incRefCount();
+    static_cast<ldr::IntrusiveCounter*>(p)->incRefCount();
   }
 }
 
 void ldr::IntrusiveCounter::decRef(void* p) {
   if (p) {
-    reinterpret_cast<ldr::IntrusiveCounter*>(p)->decRefCount();
+    static_cast<ldr::IntrusiveCounter*>(p)->decRefCount();
   }
 }
 
-void ldr::IntrusiveCounter::incRefCount() {
-#if defined(_MSC_VER)
-  InterlockedIncrement(&refCounter_);
-#else
-  __sync_fetch_and_add(&refCounter_, 1);
-#endif // _MSC_VER
+ldr::WeakControlBlock* ldr::WeakControlBlock::acquire(const void* object) {
+  WeakControlBlockTable& table = getTable();
+
+  std::lock_guard lock(table.mutex);
+
+  WeakControlBlock*& block = table.blocks[object];
+
+  if (!block) {
+    block = new WeakControlBlock();
+  }
+
+  block->addRef();
+
+  return block;
 }
 
-void ldr::IntrusiveCounter::decRefCount() {
-  assert(refCounter_ > 0);
+void ldr::WeakControlBlock::lockContended() {
+  // the lock is held only for a few instructions: spin briefly, then let the holder run if it was preempted
+  constexpr uint32_t kNumSpins = 64;
 
-  if (0 ==
-#if defined(_MSC_VER)
-      InterlockedDecrement(&refCounter_)
-#else
-      __sync_sub_and_fetch(&refCounter_, 1)
-#endif // _MSC_VER
-  ) {
-    delete this;
+  for (uint32_t i = 0;; i++) {
+    if (!locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire)) {
+      return;
+    }
+    if (i < kNumSpins) {
+      LDR_CPU_RELAX();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ldr::WeakControlBlock::detach(const void* object) {
+  WeakControlBlock* block = nullptr;
+  {
+    WeakControlBlockTable& table = getTable();
+
+    std::lock_guard lock(table.mutex);
+
+    auto it = table.blocks.find(object);
+
+    assert(it != table.blocks.end());
+
+    block = it->second;
+    table.blocks.erase(it);
   }
+
+  // wait for any clWeakPtr::lock() in flight
+  block->lock();
+  block->alive_.store(false, std::memory_order_relaxed);
+  block->unlock();
+
+  block->release();
 }
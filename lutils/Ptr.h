@@ -4,37 +4,263 @@
  *
  * Minimalistic intrusive smartpointer
  *
- * \version 1.0.0
- * \date 16/09/2022
- * \author Sergey Kosarevsky, 2022
+ * \version 1.1.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2022-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
  */
 
 #pragma once
 
+#include <assert.h>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
 namespace ldr {
 
-class IntrusiveCounter {
+// the highest bit of a reference counter marks objects which have a weak control block
+constexpr uint32_t kRefCountWeakFlag = 0x80000000u;
+// objects created by allocate_intrusive(): the function which destroys them is stored right before the object
+constexpr uint32_t kRefCountAllocatedFlag = 0x40000000u;
+constexpr uint32_t kRefCountMask = ~(kRefCountWeakFlag | kRefCountAllocatedFlag);
+
+/// destroys an object created by allocate_intrusive() and frees its memory; `object` is the most derived object
+using IntrusiveDestroyFunc = void (*)(void* object);
+
+/// thread-safe reference counter (default)
+class RefCounterAtomic {
+ public:
+  void increment(uint32_t n = 1) {
+    // a new reference can only be created from an existing one, no ordering is required
+    counter_.fetch_add(n, std::memory_order_relaxed);
+  }
+  /// drop `n` references which are not the last ones
+  void decrementNonFinal(uint32_t n) {
+    [[maybe_unused]] const uint32_t prev = counter_.fetch_sub(n, std::memory_order_release);
+    assert((prev & kRefCountMask) > n);
+  }
+  /// returns the previous value (including flags)
+  uint32_t decrement() {
+    // release: publish all writes to the object; acquire: see them before the destructor runs
+    const uint32_t prev = counter_.fetch_sub(1, std::memory_order_acq_rel);
+    assert(prev & kRefCountMask);
+    return prev;
+  }
+  /// increment unless the object is already dying
+  bool tryIncrement() {
+    uint32_t value = counter_.load(std::memory_order_relaxed);
+    do {
+      if (!(value & kRefCountMask))
+        return false;
+    } while (!counter_.compare_exchange_weak(value, value + 1, std::memory_order_acquire, std::memory_order_relaxed));
+    return true;
+  }
+  void setFlags(uint32_t flags) {
+    counter_.fetch_or(flags, std::memory_order_relaxed);
+  }
+  uint32_t getFlags() const {
+    return counter_.load(std::memory_order_relaxed) & ~kRefCountMask;
+  }
+  uint32_t load() const {
+    return counter_.load(std::memory_order_relaxed) & kRefCountMask;
+  }
+
+ private:
+  std::atomic<uint32_t> counter_ = 0;
+};
+
+/// non-atomic reference counter for objects which never cross thread boundaries
+class RefCounterSingleThreaded {
+ public:
+  void increment(uint32_t n = 1) {
+    counter_ += n;
+  }
+  void decrementNonFinal(uint32_t n) {
+    assert((counter_ & kRefCountMask) > n);
+    counter_ -= n;
+  }
+  uint32_t decrement() {
+    assert(counter_ & kRefCountMask);
+    return counter_--;
+  }
+  bool tryIncrement() {
+    if (!(counter_ & kRefCountMask))
+      return false;
+    counter_++;
+    return true;
+  }
+  void setFlags(uint32_t flags) {
+    counter_ |= flags;
+  }
+  uint32_t getFlags() const {
+    return counter_ & ~kRefCountMask;
+  }
+  uint32_t load() const {
+    return counter_ & kRefCountMask;
+  }
+
+ private:
+  uint32_t counter_ = 0;
+};
+
+/// Side control block of weakly referenced objects. It is allocated only when the first weak reference to an
+/// object is taken and is looked up by the object address, so objects themselves do not pay for it.
+class WeakControlBlock final {
+ public:
+  /// find or create the control block of `object` and add a weak reference to it
+  static WeakControlBlock* acquire(const void* object);
+  /// called by the dying `object` marked with kRefCountWeakFlag: all further lock attempts will fail
+  static void detach(const void* object);
+
+  void addRef() {
+    weakCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void release() {
+    if (weakCount_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+  /// the object cannot be destroyed while the control block is locked
+  void lock() {
+    if (locked_.exchange(true, std::memory_order_acquire))
+      lockContended();
+  }
+  void unlock() {
+    locked_.store(false, std::memory_order_release);
+  }
+  bool isAlive() const {
+    return alive_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  WeakControlBlock() = default;
+  void lockContended();
+
+ private:
+  std::atomic<uint32_t> weakCount_ = 1; // +1 held by the object itself while it is alive
+  std::atomic<bool> locked_ = false;
+  std::atomic<bool> alive_ = true;
+};
+
+/// Deferred destruction: objects whose last reference is dropped on a thread with deferral enabled are queued
+/// instead of being destroyed inline, and destroyed in batches by collect() at a safe point or by a background thread
+class DeferredReclamation final {
  public:
-  virtual ~IntrusiveCounter() = default;
-  void incRefCount();
-  void decRefCount();
+  using DestroyFunc = void (*)(void* object);
+
+  static bool isEnabled() {
+    return enabled_;
+  }
+  static void retire(void* object, DestroyFunc destroy);
+  /// hand over objects retired on this thread which are still waiting in its local batch
+  static void flush();
+  /// destroy everything retired on this thread and handed over by other threads so far; returns the number of destroyed objects
+  static size_t collect();
+  /// collect() every `periodMs` milliseconds on a dedicated thread
+  static void startBackgroundThread(uint32_t periodMs);
+  static void stopBackgroundThread();
+
+ private:
+  friend class DeferredReclamationScope;
+  static inline thread_local bool enabled_ = false;
+};
+
+/// enables deferred destruction on the current thread within a scope
+class DeferredReclamationScope final {
+ public:
+  DeferredReclamationScope() : prevEnabled_(DeferredReclamation::enabled_) {
+    DeferredReclamation::enabled_ = true;
+  }
+  ~DeferredReclamationScope() {
+    DeferredReclamation::enabled_ = prevEnabled_;
+    if (!prevEnabled_)
+      DeferredReclamation::flush();
+  }
+  DeferredReclamationScope(const DeferredReclamationScope&) = delete;
+  DeferredReclamationScope& operator=(const DeferredReclamationScope&) = delete;
+
+ private:
+  bool prevEnabled_ = false;
+};
+
+template<class CounterPolicy>
+class IntrusiveCounterBase {
+ public:
+  IntrusiveCounterBase() = default;
+  IntrusiveCounterBase(const IntrusiveCounterBase&) {} // reference counters are never copied
+  IntrusiveCounterBase& operator=(const IntrusiveCounterBase&) {
+    return *this;
+  }
+  virtual ~IntrusiveCounterBase() = default;
+  void incRefCount() {
+    refCounter_.increment();
+  }
+  /// references in bulk (see clAtomicPtr); releaseRefCount() cannot drop the last reference
+  void addRefCount(uint32_t n) {
+    refCounter_.increment(n);
+  }
+  void releaseRefCount(uint32_t n) {
+    refCounter_.decrementNonFinal(n);
+  }
+  void decRefCount() {
+    const uint32_t prev = refCounter_.decrement();
+    if ((prev & kRefCountMask) == 1) {
+      if (prev & kRefCountWeakFlag) {
+        WeakControlBlock::detach(this);
+      }
+      if (DeferredReclamation::isEnabled()) {
+        DeferredReclamation::retire(this, [](void* p) { static_cast<IntrusiveCounterBase*>(p)->destroy(); });
+      } else {
+        destroy();
+      }
+    }
+  }
+  /// used by clWeakPtr::lock()
+  bool tryIncRefCount() {
+    return refCounter_.tryIncrement();
+  }
   uint32_t useCount() const {
-    return refCounter_;
+    return refCounter_.load();
+  }
+  /// the caller should hold a strong reference; returns a weak reference to the control block
+  WeakControlBlock* acquireWeakControlBlock() {
+    assert(useCount() > 0);
+    refCounter_.setFlags(kRefCountWeakFlag);
+    return WeakControlBlock::acquire(this);
+  }
+  /// used by allocate_intrusive() before the first reference is taken
+  void markAllocated() {
+    assert(useCount() == 0);
+    refCounter_.setFlags(kRefCountAllocatedFlag);
   }
 
-  // NOTE: this is the price we pay for not using the <atomic> header
-  static void incRef(void* p);
-  static void decRef(void* p);
+ protected:
+  /// called once the last reference is gone; can be overridden by custom allocation schemes
+  virtual void destroy() {
+    if (refCounter_.getFlags() & kRefCountAllocatedFlag) {
+      void* object = dynamic_cast<void*>(this);
+      const IntrusiveDestroyFunc destroyFunc = *(static_cast<IntrusiveDestroyFunc*>(object) - 1);
+      destroyFunc(object);
+    } else {
+      delete this;
+    }
+  }
 
  private:
-  volatile uint32_t refCounter_ = 0;
+  CounterPolicy refCounter_;
 };
 
+/// thread-safe intrusive reference counter (default)
+class IntrusiveCounter : public IntrusiveCounterBase<RefCounterAtomic> {
+ public:
+  // out-of-line helpers used by clPtr<T> where T is only forward-declared (T should derive from IntrusiveCounter first)
+  static void incRef(void* p);
+  static void decRef(void* p);
+};
+
+using IntrusiveCounterSingleThreaded = IntrusiveCounterBase<RefCounterSingleThreaded>;
+
 } // namespace ldr
 
 template<class T>
@@ -42,27 +268,68 @@ class clPtr {
  public:
   clPtr() = default;
   clPtr(const clPtr& other) : value_(other.value_) {
-    ldr::IntrusiveCounter::incRef(value_);
+    if (value_)
+      incRef(value_);
   }
   template<typename U>
   clPtr(const clPtr<U>& ptr) : value_(ptr.get()) {
-    ldr::IntrusiveCounter::incRef(value_);
+    if (value_)
+      incRef(value_);
   }
   clPtr(T* const p) : value_(p) {
-    ldr::IntrusiveCounter::incRef(value_);
+    if (value_)
+      incRef(value_);
   }
   clPtr(std::nullptr_t) : value_(nullptr) {}
+  clPtr(clPtr&& other) noexcept : value_(other.release()) {}
+  template<typename U>
+  clPtr(clPtr<U>&& ptr) noexcept : value_(ptr.release()) {}
   /// destructor
   ~clPtr() {
-    ldr::IntrusiveCounter::decRef(value_);
+    if (value_)
+      decRef(value_);
   }
   clPtr& operator=(const clPtr& other) {
     T* temp = value_;
     value_ = other.value_;
-    ldr::IntrusiveCounter::incRef(other.value_);
-    ldr::IntrusiveCounter::decRef(temp);
+    if (value_)
+      incRef(value_);
+    if (temp)
+      decRef(temp);
     return *this;
   }
+  clPtr& operator=(clPtr&& other) noexcept {
+    if (this != &other) {
+      T* temp = value_;
+      value_ = other.release();
+      if (temp)
+        decRef(temp);
+    }
+    return *this;
+  }
+  void swap(clPtr& other) noexcept {
+    T* temp = value_;
+    value_ = other.value_;
+    other.value_ = temp;
+  }
+  void reset() {
+    clPtr().swap(*this);
+  }
+  void reset(T* p) {
+    clPtr(p).swap(*this);
+  }
+  /// give up ownership without decrementing the reference counter
+  [[nodiscard]] T* release() noexcept {
+    T* p = value_;
+    value_ = nullptr;
+    return p;
+  }
+  /// take ownership of an already counted reference without incrementing the reference counter
+  [[nodiscard]] static clPtr adopt(T* p) noexcept {
+    clPtr ptr;
+    ptr.value_ = p;
+    return ptr;
+  }
   inline T* operator->() const {
     return value_;
   }
@@ -118,6 +385,91 @@ class clPtr {
     return value_ != nullptr;
   }
 
+ private:
+  // inline when T is complete, otherwise through the out-of-line helpers as before
+  static void incRef(T* p) {
+    if constexpr (requires { p->incRefCount(); })
+      p->incRefCount();
+    else
+      ldr::IntrusiveCounter::incRef(p);
+  }
+  static void decRef(T* p) {
+    if constexpr (requires { p->decRefCount(); })
+      p->decRefCount();
+    else
+      ldr::IntrusiveCounter::decRef(p);
+  }
+
+ private:
+  T* value_ = nullptr;
+};
+
+template<class T>
+inline void swap(clPtr<T>& a, clPtr<T>& b) noexcept {
+  a.swap(b);
+}
+
+/// Weak counterpart of clPtr: does not keep the object alive
+template<class T>
+class clWeakPtr {
+ public:
+  clWeakPtr() = default;
+  template<typename U>
+  clWeakPtr(const clPtr<U>& ptr) : value_(ptr.get()) {
+    if (value_)
+      block_ = value_->acquireWeakControlBlock();
+  }
+  clWeakPtr(const clWeakPtr& other) : value_(other.value_), block_(other.block_) {
+    if (block_)
+      block_->addRef();
+  }
+  clWeakPtr(clWeakPtr&& other) noexcept : value_(other.value_), block_(other.block_) {
+    other.value_ = nullptr;
+    other.block_ = nullptr;
+  }
+  ~clWeakPtr() {
+    if (block_)
+      block_->release();
+  }
+  clWeakPtr& operator=(const clWeakPtr& other) {
+    clWeakPtr(other).swap(*this);
+    return *this;
+  }
+  clWeakPtr& operator=(clWeakPtr&& other) noexcept {
+    if (this != &other) {
+      reset();
+      swap(other);
+    }
+    return *this;
+  }
+  void swap(clWeakPtr& other) noexcept {
+    T* value = value_;
+    value_ = other.value_;
+    other.value_ = value;
+    ldr::WeakControlBlock* block = block_;
+    block_ = other.block_;
+    other.block_ = block;
+  }
+  void reset() {
+    clWeakPtr().swap(*this);
+  }
+  /// returns nullptr if the object is gone
+  clPtr<T> lock() const {
+    if (!block_)
+      return nullptr;
+    clPtr<T> ptr;
+    block_->lock();
+    if (block_->isAlive() && value_->tryIncRefCount()) {
+      ptr = clPtr<T>::adopt(value_);
+    }
+    block_->unlock();
+    return ptr;
+  }
+  bool expired() const {
+    return !block_ || !block_->isAlive();
+  }
+
  private:
   T* value_ = nullptr;
+  ldr::WeakControlBlock* block_ = nullptr;
 };
@@ -4,17 +4,23 @@
  *
  * Minimalistic intrusive smartpointer - utils
  *
- * \version 1.0.0
- * \date 16/09/2022
- * \author Sergey Kosarevsky, 2022
+ * \version 1.1.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2022-2026
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  * https://github.com/corporateshark/ldrutils
  */
 
 #pragma once
 
+#include "PoolAllocator.h"
 #include "Ptr.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <utility>
 
 namespace ldr {
@@ -24,4 +30,160 @@ clPtr<T> make_intrusive(Args&&... args) {
   return clPtr<T>(new T(std::forward<Args>(args)...));
 }
 
+namespace detail {
+
+/// Memory block of allocate_intrusive(): [allocator | ... | IntrusiveDestroyFunc][T]. The object is not wrapped
+/// into another type, so `final` classes, typeid() and dynamic_cast<> behave as with make_intrusive().
+template<class T, class Alloc>
+struct IntrusiveAllocation {
+  static constexpr size_t kAlignment = std::max({alignof(T), alignof(Alloc), alignof(IntrusiveDestroyFunc)});
+  static constexpr size_t kObjectOffset = (sizeof(Alloc) + sizeof(IntrusiveDestroyFunc) + kAlignment - 1) & ~(kAlignment - 1);
+
+  struct alignas(kAlignment) Block {
+    uint8_t bytes[kObjectOffset + sizeof(T)];
+  };
+  using Traits = typename std::allocator_traits<Alloc>::template rebind_traits<Block>;
+
+  static void destroy(void* object) {
+    uint8_t* bytes = static_cast<uint8_t*>(object) - kObjectOffset;
+    Alloc* storedAlloc = std::launder(reinterpret_cast<Alloc*>(bytes));
+    typename Traits::allocator_type alloc(std::move(*storedAlloc));
+    static_cast<T*>(object)->~T();
+    storedAlloc->~Alloc();
+    Traits::deallocate(alloc, reinterpret_cast<Block*>(bytes), 1);
+  }
+};
+
+} // namespace detail
+
+/// the object returns its memory to the allocator it was created with
+template<class T, class Alloc, class... Args>
+clPtr<T> allocate_intrusive(const Alloc& alloc, Args&&... args) {
+  using Allocation = detail::IntrusiveAllocation<T, Alloc>;
+  using Traits = typename Allocation::Traits;
+  typename Traits::allocator_type blockAlloc(alloc);
+  typename Allocation::Block* block = Traits::allocate(blockAlloc, 1);
+  uint8_t* bytes = block->bytes;
+  T* p = nullptr;
+  try {
+    p = ::new (static_cast<void*>(bytes + Allocation::kObjectOffset)) T(std::forward<Args>(args)...);
+  } catch (...) {
+    Traits::deallocate(blockAlloc, block, 1);
+    throw;
+  }
+  ::new (static_cast<void*>(bytes)) Alloc(alloc);
+  ::new (static_cast<void*>(bytes + Allocation::kObjectOffset - sizeof(IntrusiveDestroyFunc))) IntrusiveDestroyFunc(&Allocation::destroy);
+  p->markAllocated();
+  return clPtr<T>(p);
+}
+
+/// allocate from a per-type thread-local pool instead of the global heap
+template<class T, class... Args>
+clPtr<T> make_intrusive_pooled(Args&&... args) {
+  return allocate_intrusive<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+/// A clPtr slot which can be read and replaced concurrently without locks. The slot packs the pointer (48 bits) and
+/// the number of readers served (16 bits) into one 64-bit word, and donates kNumDonatedRefs references to the stored
+/// object in advance: load() takes one of them with a single fetch_add and never writes the slot again, except for
+/// topping up the donation once half of it is used. Replacing the value gives the unused donated references back.
+/// useCount() of a stored object includes the donated references.
+template<class T>
+class clAtomicPtr final {
+ public:
+  static constexpr uint32_t kNumDonatedRefs = 1024;
+
+  clAtomicPtr() = default;
+  explicit clAtomicPtr(clPtr<T> p) : value_(donate(p.release())) {}
+  ~clAtomicPtr() {
+    if (T* p = settle(value_.load(std::memory_order_acquire)))
+      p->decRefCount();
+  }
+  clAtomicPtr(const clAtomicPtr&) = delete;
+  clAtomicPtr& operator=(const clAtomicPtr&) = delete;
+
+  [[nodiscard]] clPtr<T> load() const {
+    const uint64_t v = value_.fetch_add(kReaderOne, std::memory_order_acquire) + kReaderOne;
+    T* p = unpack(v);
+    if (p && getNumReaders(v) >= kNumDonatedRefs / 2) {
+      topUp(v);
+    }
+    return clPtr<T>::adopt(p);
+  }
+  void store(clPtr<T> p) {
+    exchange(std::move(p));
+  }
+  /// returns the previous value
+  clPtr<T> exchange(clPtr<T> p) {
+    const uint64_t prev = value_.exchange(donate(p.release()), std::memory_order_acq_rel);
+    return clPtr<T>::adopt(settle(prev));
+  }
+  /// on failure `expected` is replaced with the current value
+  bool compareExchange(clPtr<T>& expected, clPtr<T> desired) {
+    uint64_t v = value_.load(std::memory_order_relaxed);
+    if (unpack(v) != expected.get()) {
+      expected = load();
+      return false;
+    }
+    const uint64_t desiredValue = donate(desired.get());
+    // retries when readers come in between
+    while (!value_.compare_exchange_weak(v, desiredValue, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+      if (unpack(v) != expected.get()) {
+        if (T* d = desired.get())
+          d->releaseRefCount(kNumDonatedRefs);
+        expected = load();
+        return false;
+      }
+    }
+    (void)desired.release();
+    // drop the slot's own reference to the previous value
+    if (T* prev = settle(v))
+      prev->decRefCount();
+    return true;
+  }
+
+ private:
+  static constexpr uint32_t kReaderShift = 48;
+  static constexpr uint64_t kReaderOne = uint64_t(1) << kReaderShift;
+  static constexpr uint64_t kPointerMask = kReaderOne - 1;
+
+  static T* unpack(uint64_t v) {
+    return reinterpret_cast<T*>(static_cast<uintptr_t>(v & kPointerMask));
+  }
+  static uint32_t getNumReaders(uint64_t v) {
+    return static_cast<uint32_t>(v >> kReaderShift);
+  }
+  // the slot owns one reference to the object plus kNumDonatedRefs for the readers
+  static uint64_t donate(T* p) {
+    const uint64_t v = reinterpret_cast<uintptr_t>(p);
+    assert(!(v & ~kPointerMask));
+    if (p)
+      p->addRefCount(kNumDonatedRefs);
+    return v;
+  }
+  // returns the slot's own reference after giving back the donated references nobody has taken
+  static T* settle(uint64_t v) {
+    T* p = unpack(v);
+    assert(!p || getNumReaders(v) <= kNumDonatedRefs);
+    if (p && getNumReaders(v) != kNumDonatedRefs)
+      p->releaseRefCount(kNumDonatedRefs - getNumReaders(v));
+    return p;
+  }
+  // donate the used half again; the caller holds a reference, so the object cannot go away meanwhile
+  void topUp(uint64_t v) const {
+    T* p = unpack(v);
+    constexpr uint32_t kNumRefs = kNumDonatedRefs / 2;
+    p->addRefCount(kNumRefs);
+    while (unpack(v) == p && getNumReaders(v) >= kNumRefs) {
+      if (value_.compare_exchange_weak(v, v - kNumRefs * kReaderOne, std::memory_order_relaxed, std::memory_order_relaxed))
+        return;
+    }
+    // replaced by a writer or topped up by another reader
+    p->releaseRefCount(kNumRefs);
+  }
+
+ private:
+  mutable std::atomic<uint64_t> value_ = 0;
+};
+
 } // namespace ldr
@@ -0,0 +1,378 @@
+/**
+ * \file ThreadPool.cpp
+ * \brief
+ *
+ * Work-stealing thread pool, task groups, parallelFor() and parallelReduce()
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#include "ThreadPool.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+// clang-format off
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#elif defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+// clang-format on
+
+namespace {
+
+// tasks which do not fit go to the shared queue, and if that one is full too, they are executed right away
+constexpr uint32_t kDequeCapacity = 4096;
+constexpr uint32_t kInjectedCapacity = 4096;
+
+// steal attempts before a worker goes to sleep
+constexpr uint32_t kNumStealRounds = 64;
+
+/// Chase-Lev deque (as formulated for C11 atomics by Le, Pop, Cohen and Zappa Nardelli, 2013) with a fixed capacity
+class WorkStealingDeque final {
+ public:
+  using Task = ldr::detail::ThreadPoolTask;
+
+  /// owner
+  bool push(Task* task) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= int64_t(kDequeCapacity)) {
+      return false;
+    }
+    tasks_[b & (kDequeCapacity - 1)].store(task, std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+  /// owner
+  Task* pop() {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Task* task = tasks_[b & (kDequeCapacity - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+      // the last task: race against thieves
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+  /// any thread
+  Task* steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    Task* task = tasks_[t & (kDequeCapacity - 1)].load(std::memory_order_acquire);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return task;
+  }
+
+ private:
+  alignas(ldr::kCacheLineSize) std::atomic<int64_t> top_ = 0;
+  alignas(ldr::kCacheLineSize) std::atomic<int64_t> bottom_ = 0;
+  alignas(ldr::kCacheLineSize) std::atomic<Task*> tasks_[kDequeCapacity] = {};
+};
+
+void pinThread(std::thread& thread, uint32_t cpu) {
+#if defined(_WIN32)
+  if (!SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), DWORD_PTR(1) << (cpu % (8 * sizeof(DWORD_PTR))))) {
+    printf("Cannot pin a worker thread to CPU %u\n", cpu);
+  }
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % CPU_SETSIZE, &set);
+  if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set)) {
+    printf("Cannot pin a worker thread to CPU %u\n", cpu);
+  }
+#else
+  (void)thread;
+  (void)cpu;
+#endif
+}
+
+} // namespace
+
+struct ldr::ThreadPool::Worker {
+  WorkStealingDeque deque;
+  ThreadPool* pool = nullptr;
+  std::thread thread;
+  // xorshift state to pick steal victims
+  uint32_t random = 0;
+  // only written by the owning thread
+  std::atomic<uint64_t> numTasks = 0;
+  std::atomic<uint64_t> numSteals = 0;
+  std::atomic<uint64_t> numFailedSteals = 0;
+  std::atomic<uint64_t> numIdleWaits = 0;
+};
+
+thread_local ldr::ThreadPool::Worker* ldr::ThreadPool::currentWorker_ = nullptr;
+
+ldr::ThreadPool::ThreadPool(uint32_t numWorkers, bool pinThreads) : injected_(kInjectedCapacity) {
+  const uint32_t numCPUs = std::max(1u, std::thread::hardware_concurrency());
+
+  if (numWorkers == kNumWorkersAuto) {
+    numWorkers = numCPUs - 1;
+  }
+
+  workers_.reserve(numWorkers);
+
+  for (uint32_t i = 0; i != numWorkers; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+    workers_.back()->pool = this;
+    workers_.back()->random = 0x9E3779B9u * (i + 1);
+  }
+
+  // start the threads only when all the deques they can steal from exist
+  for (uint32_t i = 0; i != numWorkers; i++) {
+    Worker* worker = workers_[i].get();
+    worker->thread = std::thread([this, worker]() { workerLoop(worker); });
+    if (pinThreads) {
+      pinThread(worker->thread, (i + 1) % numCPUs);
+    }
+  }
+}
+
+ldr::ThreadPool::~ThreadPool() {
+  stop_.store(true, std::memory_order_seq_cst);
+  epoch_.fetch_add(1, std::memory_order_seq_cst);
+  epoch_.notify_all();
+
+  for (std::unique_ptr<Worker>& w : workers_) {
+    w->thread.join();
+  }
+
+  // tasks are owned by TaskGroups which wait for them, so nothing can be left here
+  assert(injected_.empty());
+}
+
+ldr::ThreadPool& ldr::ThreadPool::getDefault() {
+  static ThreadPool pool;
+  return pool;
+}
+
+ldr::ThreadPoolStats ldr::ThreadPool::getStats() const {
+  ThreadPoolStats stats;
+
+  stats.numTasks = numExternalTasks_.load(std::memory_order_relaxed);
+  stats.numSteals = numExternalSteals_.load(std::memory_order_relaxed);
+  stats.numFailedSteals = numExternalFailedSteals_.load(std::memory_order_relaxed);
+
+  for (const std::unique_ptr<Worker>& w : workers_) {
+    stats.numTasks += w->numTasks.load(std::memory_order_relaxed);
+    stats.numSteals += w->numSteals.load(std::memory_order_relaxed);
+    stats.numFailedSteals += w->numFailedSteals.load(std::memory_order_relaxed);
+    stats.numIdleWaits += w->numIdleWaits.load(std::memory_order_relaxed);
+  }
+
+  return stats;
+}
+
+void ldr::ThreadPool::resetStats() {
+  numExternalTasks_.store(0, std::memory_order_relaxed);
+  numExternalSteals_.store(0, std::memory_order_relaxed);
+  numExternalFailedSteals_.store(0, std::memory_order_relaxed);
+
+  for (std::unique_ptr<Worker>& w : workers_) {
+    w->numTasks.store(0, std::memory_order_relaxed);
+    w->numSteals.store(0, std::memory_order_relaxed);
+    w->numFailedSteals.store(0, std::memory_order_relaxed);
+    w->numIdleWaits.store(0, std::memory_order_relaxed);
+  }
+}
+
+ldr::ThreadPool::Worker* ldr::ThreadPool::getCurrentWorker() const {
+  // a worker of another pool is an outsider here
+  return currentWorker_ && currentWorker_->pool == this ? currentWorker_ : nullptr;
+}
+
+void ldr::ThreadPool::submit(detail::ThreadPoolTask* task) {
+  Worker* self = getCurrentWorker();
+
+  const bool isQueued = (self && self->deque.push(task)) || injected_.tryPush(task);
+
+  if (!isQueued) {
+    execute(task, self);
+    return;
+  }
+
+  wake();
+}
+
+void ldr::ThreadPool::wake() {
+  epoch_.fetch_add(1, std::memory_order_seq_cst);
+  if (numSleeping_.load(std::memory_order_seq_cst)) {
+    epoch_.notify_one();
+  }
+  // a blocked waiter has to take the task when all the workers are blocked in TaskGroup::wait() themselves
+  notifyWaiters();
+}
+
+void ldr::ThreadPool::notifyWaiters() {
+  if (numBlockedWaiters_.load(std::memory_order_seq_cst)) {
+    waitEpoch_.fetch_add(1, std::memory_order_seq_cst);
+    waitEpoch_.notify_all();
+  }
+}
+
+ldr::detail::ThreadPoolTask* ldr::ThreadPool::findTask(Worker* self) {
+  detail::ThreadPoolTask* task = nullptr;
+
+  if (self && (task = self->deque.pop())) {
+    return task;
+  }
+  if (injected_.tryPop(task)) {
+    return task;
+  }
+
+  const size_t numWorkers = workers_.size();
+
+  if (!numWorkers) {
+    return nullptr;
+  }
+
+  // start from a random victim and go around once
+  uint32_t random = self ? self->random : static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&task) >> 4) | 1;
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  if (self) {
+    self->random = random;
+  }
+
+  uint64_t numFailedSteals = 0;
+
+  for (size_t i = 0; i != numWorkers; i++) {
+    Worker* victim = workers_[(random + i) % numWorkers].get();
+    if (victim == self) {
+      continue;
+    }
+    if ((task = victim->deque.steal())) {
+      break;
+    }
+    numFailedSteals++;
+  }
+
+  std::atomic<uint64_t>& steals = self ? self->numSteals : numExternalSteals_;
+  std::atomic<uint64_t>& failedSteals = self ? self->numFailedSteals : numExternalFailedSteals_;
+
+  if (task) {
+    steals.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (numFailedSteals) {
+    failedSteals.fetch_add(numFailedSteals, std::memory_order_relaxed);
+  }
+
+  return task;
+}
+
+void ldr::ThreadPool::execute(detail::ThreadPoolTask* task, Worker* self) {
+  TaskGroup* group = task->group;
+
+  try {
+    task->func();
+  } catch (...) {
+    if (!group->hasException_.exchange(true, std::memory_order_relaxed)) {
+      group->exception_ = std::current_exception();
+    }
+  }
+
+  delete task;
+
+  (self ? self->numTasks : numExternalTasks_).fetch_add(1, std::memory_order_relaxed);
+
+  // the last access to the group: TaskGroup::wait() can return and destroy it right after this
+  group->numPending_.fetch_sub(1, std::memory_order_seq_cst);
+
+  notifyWaiters();
+}
+
+void ldr::ThreadPool::workerLoop(Worker* self) {
+  currentWorker_ = self;
+
+  while (!stop_.load(std::memory_order_relaxed)) {
+    detail::ThreadPoolTask* task = nullptr;
+
+    for (uint32_t i = 0; i != kNumStealRounds && !task; i++) {
+      task = findTask(self);
+    }
+
+    if (task) {
+      execute(task, self);
+      continue;
+    }
+
+    // announce the intention to sleep, then look once more: submit() bumps the epoch before checking numSleeping_
+    numSleeping_.fetch_add(1, std::memory_order_seq_cst);
+    const uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+
+    task = findTask(self);
+
+    if (!task && !stop_.load(std::memory_order_seq_cst)) {
+      self->numIdleWaits.fetch_add(1, std::memory_order_relaxed);
+      epoch_.wait(epoch, std::memory_order_seq_cst);
+    }
+
+    numSleeping_.fetch_sub(1, std::memory_order_seq_cst);
+
+    if (task) {
+      execute(task, self);
+    }
+  }
+
+  currentWorker_ = nullptr;
+}
+
+void ldr::TaskGroup::wait() {
+  waitForTasks();
+
+  if (hasException_.load(std::memory_order_relaxed)) {
+    std::exception_ptr exception = std::exchange(exception_, nullptr);
+    hasException_.store(false, std::memory_order_relaxed);
+    std::rethrow_exception(exception);
+  }
+}
+
+void ldr::TaskGroup::waitForTasks() {
+  ThreadPool::Worker* self = pool_.getCurrentWorker();
+
+  while (numPending_.load(std::memory_order_acquire)) {
+    detail::ThreadPoolTask* task = pool_.findTask(self);
+
+    if (!task) {
+      // same handshake as the idle workers: announce the intention to block, then look once more. execute() decrements
+      // numPending_ before checking numBlockedWaiters_, so either the wake-up is seen here or the epoch is bumped.
+      pool_.numBlockedWaiters_.fetch_add(1, std::memory_order_seq_cst);
+      const uint32_t epoch = pool_.waitEpoch_.load(std::memory_order_seq_cst);
+
+      if (numPending_.load(std::memory_order_seq_cst) && !(task = pool_.findTask(self))) {
+        pool_.waitEpoch_.wait(epoch, std::memory_order_seq_cst);
+      }
+
+      pool_.numBlockedWaiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    if (task) {
+      pool_.execute(task, self);
+    }
+  }
+}
@@ -0,0 +1,224 @@
+/**
+ * \file ThreadPool.h
+ * \brief
+ *
+ * Work-stealing thread pool, task groups, parallelFor() and parallelReduce()
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ConcurrentQueue.h"
+
+namespace ldr {
+
+class TaskGroup;
+
+namespace detail {
+
+struct ThreadPoolTask {
+  std::function<void()> func;
+  TaskGroup* group = nullptr;
+};
+
+} // namespace detail
+
+/// Totals over all threads since the pool was created (or the last resetStats())
+struct ThreadPoolStats {
+  /// tasks executed by the workers and by the threads waiting in TaskGroup::wait()
+  uint64_t numTasks = 0;
+  /// tasks taken from another worker's deque
+  uint64_t numSteals = 0;
+  /// attempts to steal from a worker which had nothing to give (or lost the race for the last task)
+  uint64_t numFailedSteals = 0;
+  /// times a worker found no work anywhere and went to sleep
+  uint64_t numIdleWaits = 0;
+};
+
+/// Every worker owns a Chase-Lev deque: it pushes and pops tasks at the bottom (LIFO, cache-hot), idle workers steal
+/// from the top of a random victim (FIFO, the largest pieces of work). Tasks submitted by other threads go through
+/// a shared MPMCQueue. Threads waiting for a TaskGroup execute pending tasks and only block when there is nothing left
+/// to take, so nested parallelism cannot deadlock and a pool with 0 workers runs everything on the waiting thread.
+class ThreadPool final {
+ public:
+  static constexpr uint32_t kNumWorkersAuto = ~0u;
+
+  /// `numWorkers` threads besides the calling one (kNumWorkersAuto - one per hardware thread minus one). With `pinThreads`
+  /// the i-th worker is bound to the (i+1)-th logical CPU (Linux and Windows), the 0-th one is left to the calling thread.
+  explicit ThreadPool(uint32_t numWorkers = kNumWorkersAuto, bool pinThreads = false);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// a lazily created pool with one worker per hardware thread minus one, used by default everywhere in the library
+  static ThreadPool& getDefault();
+
+  /// workers + the thread which waits for the results
+  uint32_t getNumThreads() const {
+    return static_cast<uint32_t>(workers_.size()) + 1;
+  }
+  ThreadPoolStats getStats() const;
+  void resetStats();
+
+ private:
+  friend class TaskGroup;
+  struct Worker;
+
+  Worker* getCurrentWorker() const;
+  void submit(detail::ThreadPoolTask* task);
+  detail::ThreadPoolTask* findTask(Worker* self);
+  void execute(detail::ThreadPoolTask* task, Worker* self);
+  void workerLoop(Worker* self);
+  void wake();
+  void notifyWaiters();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // tasks submitted by non-worker threads and overflows of the worker deques
+  MPMCQueue<detail::ThreadPoolTask*> injected_;
+  // the stats of the non-worker threads
+  std::atomic<uint64_t> numExternalTasks_ = 0;
+  std::atomic<uint64_t> numExternalSteals_ = 0;
+  std::atomic<uint64_t> numExternalFailedSteals_ = 0;
+  // bumped on every submission, sleeping workers wait for it to change
+  alignas(kCacheLineSize) std::atomic<uint32_t> epoch_ = 0;
+  std::atomic<uint32_t> numSleeping_ = 0;
+  std::atomic<bool> stop_ = false;
+  // bumped when a task finishes or is submitted while some thread is blocked in TaskGroup::wait(). It lives in the pool
+  // and not in the group: the group can be destroyed as soon as its last task has decremented the counter.
+  alignas(kCacheLineSize) std::atomic<uint32_t> waitEpoch_ = 0;
+  std::atomic<uint32_t> numBlockedWaiters_ = 0;
+
+  static thread_local Worker* currentWorker_;
+};
+
+/// A set of tasks which can be waited for. Tasks can add more tasks to their own group. If tasks throw, the rest
+/// of the group still runs and wait() rethrows the first exception.
+class TaskGroup final {
+ public:
+  explicit TaskGroup(ThreadPool& pool = ThreadPool::getDefault()) : pool_(pool) {}
+  ~TaskGroup() {
+    // cannot throw here: the group can be destroyed during stack unwinding
+    waitForTasks();
+  }
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  template<typename Func>
+  void run(Func&& func) {
+    numPending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.submit(new detail::ThreadPoolTask{std::function<void()>(std::forward<Func>(func)), this});
+  }
+  /// executes pending tasks of the pool on the calling thread until all tasks of this group are done
+  void wait();
+
+ private:
+  friend class ThreadPool;
+
+  void waitForTasks();
+
+  ThreadPool& pool_;
+  std::atomic<uint32_t> numPending_ = 0;
+  // only the first exception is kept
+  std::atomic<bool> hasException_ = false;
+  std::exception_ptr exception_;
+};
+
+namespace detail {
+
+inline size_t getDefaultGrainSize(size_t numItems, const ThreadPool& pool) {
+  // several chunks per thread leave room for load balancing
+  return std::max<size_t>(1, numItems / (8 * size_t(pool.getNumThreads())));
+}
+
+// hand out the upper halves to thieves and keep working on the lower half
+template<typename Func>
+void parallelForSplit(TaskGroup& group, size_t begin, size_t end, size_t grainSize, const Func& func) {
+  while (end - begin > grainSize) {
+    const size_t mid = begin + (end - begin) / 2;
+    group.run([&group, mid, end, grainSize, &func]() { parallelForSplit(group, mid, end, grainSize, func); });
+    end = mid;
+  }
+  func(begin, end);
+}
+
+} // namespace detail
+
+/// Call `func(i0, i1)` for subranges [i0..i1) of [begin..end) no longer than `grainSize` (0 - a few per thread)
+template<typename Func>
+void parallelFor(size_t begin, size_t end, const Func& func, size_t grainSize = 0, ThreadPool& pool = ThreadPool::getDefault()) {
+  if (begin >= end) {
+    return;
+  }
+  if (!grainSize) {
+    grainSize = detail::getDefaultGrainSize(end - begin, pool);
+  }
+  if (end - begin <= grainSize || pool.getNumThreads() == 1) {
+    func(begin, end);
+    return;
+  }
+  TaskGroup group(pool);
+  detail::parallelForSplit(group, begin, end, grainSize, func);
+  group.wait();
+}
+
+/// `map(i0, i1)` returns T for every chunk [i0..i1) of `grainSize` elements, the chunks are combined with `reduce(T, T)`
+/// from left to right starting with `identity`: the result does not depend on the scheduling (e.g. float sums are reproducible).
+template<typename T, typename Map, typename Reduce>
+T parallelReduce(size_t begin,
+                 size_t end,
+                 T identity,
+                 const Map& map,
+                 const Reduce& reduce,
+                 size_t grainSize = 0,
+                 ThreadPool& pool = ThreadPool::getDefault()) {
+  if (begin >= end) {
+    return identity;
+  }
+  if (!grainSize) {
+    grainSize = detail::getDefaultGrainSize(end - begin, pool);
+  }
+
+  // no std::vector<bool> packing: every chunk is written by its own thread
+  struct Partial {
+    T value;
+  };
+
+  const size_t numChunks = (end - begin + grainSize - 1) / grainSize;
+  std::vector<Partial> partials(numChunks, Partial{identity});
+
+  parallelFor(
+      0,
+      numChunks,
+      [&](size_t c0, size_t c1) {
+        for (size_t c = c0; c != c1; c++) {
+          const size_t i0 = begin + c * grainSize;
+          partials[c].value = map(i0, std::min(i0 + grainSize, end));
+        }
+      },
+      1,
+      pool);
+
+  T result = std::move(identity);
+  for (Partial& p : partials) {
+    result = reduce(std::move(result), std::move(p.value));
+  }
+  return result;
+}
+
+} // namespace ldr
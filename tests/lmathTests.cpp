@@ -11,15 +11,26 @@
  * https://github.com/corporateshark/ldrutils
  */
 
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <stdio.h>
+#include <vector>
 
+#include <lmath/BitmapBlending.h>
 #include <lmath/Blending.h>
+#include <lmath/ColorConversion.h>
 #include <lmath/Geometry.h>
+#include <lmath/GeometryShapesCodec.h>
+#include <lmath/LowDiscrepancy.h>
 #include <lmath/Math.h>
 #include <lmath/Matrix.h>
 #include <lmath/Plane.h>
+#include <lmath/Random.h>
+#include <lmath/RandomGenerators.h>
+#include <lmath/RandomSampling.h>
+#include <lmath/Serialization.h>
 #include <lmath/Vector.h>
+#include <lutils/MappedFile.h>
 
 namespace ltests {
 
@@ -277,4 +288,459 @@ GTEST_TEST(lmath, mat3_rotate2) {
   testRotate(normalize(vec3(1.0f, 0.0f, 1.0f)), normalize(-vec3(1.0f, 1.0f, 1.0f)), eps);
 }
 
+GTEST_TEST(lmath, random_fill) {
+  // bulk generation should produce exactly the scalar sequence
+  for (size_t n : {0, 3, 8, 17, 1000}) {
+    LRandom r1;
+    LRandom r2;
+    r1.seed_ = r2.seed_ = 12345;
+    float values[1000];
+    r1.fill(values, n);
+    for (size_t i = 0; i != n; i++) {
+      ASSERT_EQ(values[i], r2.random());
+    }
+    ASSERT_EQ(r1.seed_, r2.seed_);
+  }
+
+  LRandom r;
+  vec3 v[100];
+  r.fillVector3InRange(v, 100, vec3(-1.0f, 2.0f, 5.0f), vec3(1.0f, 3.0f, 5.0f));
+  for (const vec3& p : v) {
+    ASSERT_TRUE(p.x >= -1.0f && p.x <= 1.0f);
+    ASSERT_TRUE(p.y >= 2.0f && p.y <= 3.0f);
+    ASSERT_TRUE(p.z == 5.0f);
+  }
+}
+
+GTEST_TEST(lmath, random_generators) {
+  // reference values from pcg32-demo: seed 42, stream 54
+  LRandomPCG32 pcg(42u, 54u);
+  const uint32_t pcgRef[] = {0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e};
+  for (uint32_t v : pcgRef) {
+    ASSERT_EQ(pcg.next(), v);
+  }
+  LRandomPCG32 pcg1(7u);
+  LRandomPCG32 pcg2(7u);
+  for (int i = 0; i != 1000; i++) {
+    (void)pcg1.next();
+  }
+  pcg2.advance(1000);
+  ASSERT_EQ(pcg1.next(), pcg2.next());
+
+  // Random123 known-answer tests for Philox4x32-10
+  uint32_t block[4];
+  const uint32_t zero[4] = {0, 0, 0, 0};
+  LRandomPhilox::generateBlock(zero, zero, block);
+  ASSERT_EQ(block[0], 0x6627e8d5u);
+  ASSERT_EQ(block[1], 0xe169c58du);
+  ASSERT_EQ(block[2], 0xbc57ac4cu);
+  ASSERT_EQ(block[3], 0x9b00dbd8u);
+  const uint32_t ctr[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  const uint32_t key[2] = {0xa4093822, 0x299f31d0};
+  LRandomPhilox::generateBlock(ctr, key, block);
+  ASSERT_EQ(block[0], 0xd16cfe09u);
+  ASSERT_EQ(block[1], 0x94fdccebu);
+  ASSERT_EQ(block[2], 0x5001e420u);
+  ASSERT_EQ(block[3], 0x24126ea1u);
+
+  // seeking is equivalent to generating
+  LRandomPhilox philox1(123u, 5u);
+  LRandomPhilox philox2(123u, 5u);
+  for (int i = 0; i != 4 * 10; i++) {
+    (void)philox1.next();
+  }
+  philox2.seek(10);
+  ASSERT_EQ(philox1.next(), philox2.next());
+
+  LRandomXoshiro256PlusPlus x1(1u);
+  LRandomXoshiro256PlusPlus x2 = x1.split();
+  ASSERT_NE(x1.next64(), x2.next64());
+
+  LRandomXoshiro128Plus x3(1u);
+  const vec3 v = x3.randomVector3InRange(vec3(1.0f), vec3(2.0f));
+  ASSERT_TRUE(v.x >= 1.0f && v.x <= 2.0f);
+  float values[100];
+  x3.fill(values, 100);
+  for (float f : values) {
+    ASSERT_TRUE(f >= 0.0f && f < 1.0f);
+  }
+}
+
+GTEST_TEST(lmath, simd_sinCos2Pi) {
+  for (int i = 0; i != 10000; i++) {
+    const float u = static_cast<float>(i) / 10000.0f;
+    ldr::simd::f32x1 s, c;
+    ldr::simd::sinCos2Pi(ldr::simd::f32x1(u), s, c);
+    ASSERT_NEAR(s.v, sinf(LMATH_TWOPI * u), 1e-6f);
+    ASSERT_NEAR(c.v, cosf(LMATH_TWOPI * u), 1e-6f);
+  }
+}
+
+GTEST_TEST(lmath, random_sampling) {
+  const size_t n = 1001;
+  const float eps = 1e-5f;
+  LRandom r;
+  std::vector<vec3> v(n);
+  std::vector<vec2> d(n);
+
+  ldr::fillUnitSphereSurface(r, v.data(), n);
+  for (const vec3& p : v) {
+    ASSERT_NEAR(p.length(), 1.0f, eps);
+  }
+  ldr::fillInsideUnitSphere(r, v.data(), n);
+  for (const vec3& p : v) {
+    ASSERT_LE(p.length(), 1.0f + eps);
+  }
+  ldr::fillUnitHemisphere(r, v.data(), n);
+  for (const vec3& p : v) {
+    ASSERT_NEAR(p.length(), 1.0f, eps);
+    ASSERT_GE(p.z, 0.0f);
+  }
+  ldr::fillCosineWeightedHemisphere(r, v.data(), n);
+  for (const vec3& p : v) {
+    ASSERT_NEAR(p.length(), 1.0f, eps);
+    ASSERT_GE(p.z, 0.0f);
+  }
+  ldr::fillInsideUnitDisk(r, d.data(), n);
+  for (const vec2& p : d) {
+    ASSERT_LE(p.length(), 1.0f + eps);
+  }
+  ldr::fillInsideTriangle(r, v.data(), n, vec3(0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+  for (const vec3& p : v) {
+    ASSERT_TRUE(p.x >= -eps && p.y >= -eps && p.x + p.y <= 1.0f + eps);
+  }
+
+  // scalar versions
+  for (size_t i = 0; i != n; i++) {
+    ASSERT_NEAR(r.randomVector3OnUnitSphereSurface().length(), 1.0f, eps);
+    ASSERT_LE(r.randomVector3InsideUnitSphere().length(), 1.0f + eps);
+    ASSERT_NEAR(r.randomVector3OnUnitSphereSurfaceRejectionFree().length(), 1.0f, eps);
+    ASSERT_LE(r.randomVector3InsideUnitSphereRejectionFree().length(), 1.0f + eps);
+    ASSERT_GE(r.randomVector3CosineWeightedHemisphere().z, 0.0f);
+    ASSERT_LE(r.randomVector2InsideUnitDisk().length(), 1.0f + eps);
+  }
+}
+
+GTEST_TEST(lmath, low_discrepancy) {
+  LHalton halton;
+  ASSERT_EQ(halton.nextVector3(), vec3(0.0f, 0.0f, 0.0f));
+  const vec3 h1 = halton.nextVector3();
+  ASSERT_FLOAT_EQ(h1.x, 1.0f / 2.0f);
+  ASSERT_FLOAT_EQ(h1.y, 1.0f / 3.0f);
+  ASSERT_FLOAT_EQ(h1.z, 1.0f / 5.0f);
+  const vec3 h2 = halton.nextVector3();
+  ASSERT_FLOAT_EQ(h2.x, 1.0f / 4.0f);
+  ASSERT_FLOAT_EQ(h2.y, 2.0f / 3.0f);
+  ASSERT_FLOAT_EQ(h2.z, 2.0f / 5.0f);
+
+  LSobol sobol;
+  vec2 s[4];
+  sobol.fillVector2(s, 4);
+  const float sobolRef[4][2] = {{0.0f, 0.0f}, {0.5f, 0.5f}, {0.25f, 0.75f}, {0.75f, 0.25f}};
+  for (size_t i = 0; i != 4; i++) {
+    ASSERT_EQ(s[i].x, sobolRef[i][0]);
+    ASSERT_EQ(s[i].y, sobolRef[i][1]);
+  }
+
+  // every power-of-2 prefix of (scrambled) Sobol and R2 points should be well stratified in each dimension
+  auto isStratified = [](const vec3* v, size_t n, size_t dim) {
+    std::vector<bool> used(n, false);
+    for (size_t i = 0; i != n; i++) {
+      const size_t cell = static_cast<size_t>(v[i][dim] * n);
+      if (cell >= n || used[cell])
+        return false;
+      used[cell] = true;
+    }
+    return true;
+  };
+  for (uint32_t seed : {0u, 1u, 12345u}) {
+    LSobol scrambled(seed);
+    vec3 v[64];
+    scrambled.fillVector3(v, 64);
+    for (size_t dim = 0; dim != 3; dim++) {
+      ASSERT_TRUE(isStratified(v, 64, dim));
+    }
+  }
+
+  LRSequence r2;
+  vec2 r[256];
+  r2.fillVector2(r, 256);
+  double sumX = 0.0;
+  for (const vec2& p : r) {
+    ASSERT_TRUE(p.x >= 0.0f && p.x < 1.0f && p.y >= 0.0f && p.y < 1.0f);
+    sumX += p.x;
+  }
+  ASSERT_NEAR(sumX / 256.0, 0.5, 0.01);
+}
+
+GTEST_TEST(lmath, blendBitmaps) {
+  using BlendFunc = float (*)(float, float);
+  // clang-format off
+  const BlendFunc funcs[] = {
+    ldr::blend_Normal, ldr::blend_Lighten, ldr::blend_Darken, ldr::blend_Multiply, ldr::blend_Average, ldr::blend_Add,
+    ldr::blend_Subtract, ldr::blend_Difference, ldr::blend_Negation, ldr::blend_Screen, ldr::blend_Exclusion,
+    ldr::blend_Overlay, ldr::blend_SoftLight, ldr::blend_HardLight, ldr::blend_ColorDodge, ldr::blend_ColorBurn,
+    ldr::blend_LinearDodge, ldr::blend_LinearBurn, ldr::blend_LinearLight, ldr::blend_VividLight, ldr::blend_PinLight,
+    ldr::blend_HardMix, ldr::blend_Reflect, ldr::blend_Glow, ldr::blend_Phoenix,
+  };
+  // clang-format on
+  static_assert(sizeof(funcs) / sizeof(funcs[0]) == ldr::eBlendMode_Count);
+
+  // odd sizes to exercise the scalar tails
+  const size_t w = 37;
+  const size_t h = 5;
+  LRandom rng;
+  std::vector<vec4> base(w * h);
+  std::vector<vec4> overlay(w * h);
+  std::vector<vec4> out(w * h);
+  rng.fillVector4InRange(base.data(), w * h, vec4(0.0f), vec4(1.0f));
+  rng.fillVector4InRange(overlay.data(), w * h, vec4(0.0f), vec4(1.0f));
+  // exact conditional edges
+  overlay[0] = vec4(0.5f, 0.0f, 1.0f, 0.0f);
+
+  for (int mode = 0; mode != ldr::eBlendMode_Count; mode++) {
+    for (float opacity : {1.0f, 0.25f}) {
+      ldr::blendBitmaps(ldr::eBlendMode(mode), base.data(), overlay.data(), out.data(), w, h, opacity, 2);
+      for (size_t i = 0; i != w * h; i++) {
+        for (size_t c = 0; c != 3; c++) {
+          const float expected = ldr::lerp(base[i][c], funcs[mode](base[i][c], overlay[i][c]), opacity);
+          ASSERT_NEAR(out[i][c], expected, 1e-5f) << "mode " << mode;
+        }
+        ASSERT_EQ(out[i].w, base[i].w);
+      }
+    }
+  }
+
+  // large enough to be split between threads
+  const size_t bigW = 512;
+  const size_t bigH = 300;
+  std::vector<vec4> big(bigW * bigH, vec4(0.5f, 0.25f, 1.0f, 0.0f));
+  ldr::blendBitmaps(ldr::eBlendMode_Screen, big.data(), big.data(), big.data(), bigW, bigH, 1.0f, 3);
+  for (const vec4& p : big) {
+    ASSERT_EQ(p, vec4(0.75f, 0.4375f, 1.0f, 0.0f));
+  }
+
+  std::vector<vec4b> base8(w * h, vec4b(200, 100, 0, 77));
+  std::vector<vec4b> overlay8(w * h, vec4b(255, 128, 50, 0));
+  std::vector<vec4b> out8(w * h);
+  ldr::blendBitmaps(ldr::eBlendMode_Multiply, base8.data(), overlay8.data(), out8.data(), w, h);
+  for (const vec4b& p : out8) {
+    ASSERT_EQ(p.x, 200);
+    ASSERT_EQ(p.y, 50);
+    ASSERT_EQ(p.z, 0);
+    ASSERT_EQ(p.w, 77);
+  }
+}
+
+GTEST_TEST(lmath, blendBitmaps8) {
+  // fixed-point modes should stay within 1 LSB of the float path, the rest should match it exactly
+  const size_t w = 29;
+  const size_t h = 7;
+  LRandom rng;
+  std::vector<vec4b> base8(w * h);
+  std::vector<vec4b> overlay8(w * h);
+  std::vector<vec4b> out8(w * h);
+  for (size_t i = 0; i != 4 * w * h; i++) {
+    (&base8[0].x)[i] = static_cast<uint8_t>(rng.randomInRange(0.0f, 255.99f));
+    (&overlay8[0].x)[i] = static_cast<uint8_t>(rng.randomInRange(0.0f, 255.99f));
+  }
+  // extreme and conditional edge values
+  base8[0] = vec4b(0, 255, 255, 0);
+  overlay8[0] = vec4b(255, 0, 255, 255);
+  base8[1] = vec4b(128, 127, 255, 1);
+  overlay8[1] = vec4b(127, 128, 128, 2);
+
+  std::vector<vec4> base(w * h);
+  std::vector<vec4> overlay(w * h);
+  std::vector<vec4> out(w * h);
+  for (size_t i = 0; i != 4 * w * h; i++) {
+    (&base[0].x)[i] = (&base8[0].x)[i] / 255.0f;
+    (&overlay[0].x)[i] = (&overlay8[0].x)[i] / 255.0f;
+  }
+
+  for (int mode = 0; mode != ldr::eBlendMode_Count; mode++) {
+    for (float opacity : {1.0f, 0.6f}) {
+      ldr::blendBitmaps(ldr::eBlendMode(mode), base8.data(), overlay8.data(), out8.data(), w, h, opacity, 2);
+      ldr::blendBitmaps(ldr::eBlendMode(mode), base.data(), overlay.data(), out.data(), w, h, opacity, 2);
+      for (size_t i = 0; i != 4 * w * h; i++) {
+        const uint8_t value = (&out8[0].x)[i];
+        if (i % 4 == 3) {
+          ASSERT_EQ(value, (&base8[0].x)[i]);
+          continue;
+        }
+        const int expected = static_cast<int>(ldr::clamp((&out[0].x)[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        ASSERT_LE(std::abs(value - expected), 1) << "mode " << mode << " channel " << i;
+      }
+    }
+  }
+}
+
+GTEST_TEST(lmath, colorConversion) {
+  const vec4b c(vec4(0.5f, -1.0f, 2.0f, 0.998f));
+  ASSERT_EQ(c.x, 128);
+  ASSERT_EQ(c.y, 0);
+  ASSERT_EQ(c.z, 255);
+  ASSERT_EQ(c.w, 254);
+
+  // odd count to exercise the scalar tails
+  const size_t n = 37;
+  LRandom rng;
+  std::vector<vec4> src(n);
+  std::vector<vec4b> dst(n);
+  std::vector<vec4> back(n);
+  rng.fillVector4InRange(src.data(), n, vec4(-0.25f), vec4(1.25f));
+
+  ldr::convertToRGBA8(src, dst);
+  for (size_t i = 0; i != n; i++) {
+    const vec4b expected(src[i]);
+    ASSERT_TRUE(dst[i].x == expected.x && dst[i].y == expected.y && dst[i].z == expected.z && dst[i].w == expected.w);
+  }
+  ldr::convertToRGBA32F(dst, back);
+  for (size_t i = 0; i != n; i++) {
+    ASSERT_FLOAT_EQ(back[i].x, dst[i].x / 255.0f);
+    ASSERT_FLOAT_EQ(back[i].w, dst[i].w / 255.0f);
+  }
+
+  // every sRGB value survives decoding and encoding
+  std::vector<vec4b> srgb(256);
+  std::vector<vec4> linear(256);
+  for (int i = 0; i != 256; i++) {
+    srgb[i] = vec4b(uint8_t(i), uint8_t(255 - i), uint8_t(i / 2), uint8_t(i));
+  }
+  ldr::decodeSRGB8(srgb, linear);
+  ASSERT_NEAR(linear[128].x, 0.2158605f, 1e-6f);
+  ASSERT_FLOAT_EQ(linear[128].w, 128 / 255.0f);
+  std::vector<vec4b> encoded(256);
+  ldr::encodeSRGB8(linear, encoded);
+  for (int i = 0; i != 256; i++) {
+    ASSERT_TRUE(encoded[i].x == srgb[i].x && encoded[i].y == srgb[i].y && encoded[i].z == srgb[i].z && encoded[i].w == srgb[i].w) << i;
+  }
+
+  ldr::encodeSRGB8(src, dst);
+  for (size_t i = 0; i != n; i++) {
+    const float expected = ldr::linearToSrgb(ldr::clamp(src[i].y, 0.0f, 1.0f)) * 255.0f + 0.5f;
+    ASSERT_LE(std::abs(dst[i].y - static_cast<int>(expected)), 1);
+    ASSERT_NEAR(ldr::srgbToLinear(ldr::linearToSrgb(src[i].x)), src[i].x, 1e-5f);
+  }
+}
+
+GTEST_TEST(lmath, compressVertices) {
+  std::vector<GeometryShapes::Vertex> mesh = GeometryShapes::createIcoSphere(vec3(1, 2, 3), 5.0f, 4);
+  GeometryShapes::addAxisAlignedBox(mesh, vec3(-3, 0, 1), vec3(0.5f, 2.0f, 1.0f));
+
+  const GeometryShapes::VertexQuantization quantization;
+  const std::vector<uint8_t> compressed = GeometryShapes::compressVertices(mesh, quantization);
+  ASSERT_LT(compressed.size() * 3, mesh.size() * sizeof(GeometryShapes::Vertex));
+
+  std::vector<GeometryShapes::Vertex> decompressed;
+  ASSERT_TRUE(GeometryShapes::decompressVertices(compressed, decompressed));
+  ASSERT_EQ(decompressed.size(), mesh.size());
+
+  // the bounding box is [-3.5..6]x[-3..7]x[-2..8]: half a quantization step of the largest extent
+  const float posError = 10.0f / float((1u << quantization.positionBits) - 1);
+  for (size_t i = 0; i != mesh.size(); i++) {
+    ASSERT_NEAR(decompressed[i].pos.x, mesh[i].pos.x, posError) << i;
+    ASSERT_NEAR(decompressed[i].pos.y, mesh[i].pos.y, posError) << i;
+    ASSERT_NEAR(decompressed[i].pos.z, mesh[i].pos.z, posError) << i;
+    ASSERT_NEAR(decompressed[i].uv.x, mesh[i].uv.x, 1e-3f) << i;
+    ASSERT_NEAR(decompressed[i].uv.y, mesh[i].uv.y, 1e-3f) << i;
+    ASSERT_GT(dot(decompressed[i].normal, normalize(mesh[i].normal)), 0.9999f) << i;
+  }
+
+  // truncated and corrupted streams are rejected
+  ASSERT_FALSE(GeometryShapes::decompressVertices(std::span(compressed).first(compressed.size() / 2), decompressed));
+  ASSERT_FALSE(GeometryShapes::decompressVertices(std::span(compressed).first(16), decompressed));
+  std::vector<uint8_t> corrupted = compressed;
+  corrupted[0] ^= 1;
+  ASSERT_FALSE(GeometryShapes::decompressVertices(corrupted, decompressed));
+
+  std::vector<GeometryShapes::Vertex> empty;
+  ASSERT_TRUE(GeometryShapes::decompressVertices(GeometryShapes::compressVertices(empty), decompressed));
+  ASSERT_TRUE(decompressed.empty());
+}
+
+GTEST_TEST(lmath, serialization) {
+  const std::string fileName = (std::filesystem::temp_directory_path() / "lmath_serialization.bin").string();
+
+  std::vector<mat4> matrices;
+  for (int i = 0; i != 100; i++) {
+    matrices.push_back(mat4(float(i)) * mat4(vec4(1, 2, 3, 4), vec4(5, 6, 7, 8), vec4(9, 10, 11, 12), vec4(13, 14, 15, 16)));
+  }
+  const vec3 points[] = {vec3(1.0f, 2.0f, 3.0f), vec3(-1.0f, 0.5f, 0.25f), vec3(7.0f, 8.0f, 9.0f)};
+  const ldr::plane3 planes[] = {ldr::plane3(0.0f, 1.0f, 0.0f, -2.0f)};
+  const ldr::ray3 rays[] = {ldr::ray3(vec3(1.0f, 1.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f))};
+
+  {
+    FILE* f = fopen(fileName.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    ASSERT_TRUE(ldr::writeArray(f, matrices));
+    ASSERT_TRUE(ldr::writeArray(f, points));
+    ASSERT_TRUE(ldr::writeArray(f, planes));
+    ASSERT_TRUE(ldr::writeArray(f, rays));
+    fclose(f);
+  }
+
+  const size_t sizeMatrices = ldr::getSerializedSize<mat4>(matrices.size());
+  const size_t sizePoints = ldr::getSerializedSize<vec3>(3);
+  const size_t sizePlanes = ldr::getSerializedSize<ldr::plane3>(1);
+  ASSERT_EQ(sizePoints, 32 + 48);
+  ASSERT_EQ(std::filesystem::file_size(fileName), sizeMatrices + sizePoints + sizePlanes + ldr::getSerializedSize<ldr::ray3>(1));
+
+  {
+    ldr::MappedFile file;
+    ASSERT_TRUE(file.open(fileName.c_str(), ldr::eMappedFileMode_ReadOnly));
+    std::span<const uint8_t> data(file.data(), file.size());
+
+    // zero-copy: the spans point into the mapping
+    const auto viewMatrices = ldr::viewArray<mat4>(data);
+    ASSERT_TRUE(viewMatrices.has_value());
+    ASSERT_EQ(viewMatrices->size(), matrices.size());
+    ASSERT_EQ(reinterpret_cast<const uint8_t*>(viewMatrices->data()), file.data() + sizeof(ldr::SerializedArrayHeader));
+    ASSERT_TRUE((*viewMatrices)[42] == matrices[42]);
+    ASSERT_TRUE((*viewMatrices)[99] == matrices[99]);
+    data = data.subspan(sizeMatrices);
+
+    ASSERT_FALSE(ldr::viewArray<vec4>(data).has_value());
+    const auto viewPoints = ldr::viewArray<vec3>(data);
+    ASSERT_TRUE(viewPoints.has_value());
+    ASSERT_EQ(viewPoints->size(), 3);
+    ASSERT_TRUE((*viewPoints)[1] == points[1]);
+    data = data.subspan(sizePoints);
+
+    const auto viewPlanes = ldr::viewArray<ldr::plane3>(data);
+    ASSERT_TRUE(viewPlanes.has_value());
+    ASSERT_EQ((*viewPlanes)[0].d, -2.0f);
+    ASSERT_TRUE((*viewPlanes)[0].n == vec3(0.0f, 1.0f, 0.0f));
+    data = data.subspan(sizePlanes);
+
+    std::vector<ldr::ray3> readRays;
+    ASSERT_TRUE(ldr::readArray(data, readRays));
+    ASSERT_EQ(readRays.size(), 1);
+    ASSERT_TRUE(readRays[0].orig == rays[0].orig && readRays[0].dir == rays[0].dir);
+
+    ASSERT_FALSE(ldr::viewArray<ldr::ray3>(data.first(40)).has_value());
+  }
+
+  std::filesystem::remove(fileName);
+
+  // in-memory, at an odd offset: only copying reads work
+  std::vector<uint8_t> buffer(1);
+  ldr::serializeArray(std::span<const vec3>(points), buffer);
+  ASSERT_EQ(buffer.size(), 1 + sizePoints);
+  const std::span<const uint8_t> unaligned = std::span<const uint8_t>(buffer).subspan(1);
+  if (reinterpret_cast<uintptr_t>(unaligned.data()) % alignof(vec3)) {
+    ASSERT_FALSE(ldr::viewArray<vec3>(unaligned).has_value());
+  }
+  std::vector<vec3> readPoints;
+  ASSERT_TRUE(ldr::readArray(unaligned, readPoints));
+  ASSERT_TRUE(readPoints[2] == points[2]);
+
+  // only the current version is readable
+  for (const uint32_t version : {0u, ldr::SerializedArrayHeader::kVersion + 1}) {
+    std::vector<uint8_t> patched(buffer.begin() + 1, buffer.end());
+    memcpy(patched.data() + offsetof(ldr::SerializedArrayHeader, version), &version, sizeof(version));
+    ASSERT_FALSE(ldr::readArray(std::span<const uint8_t>(patched), readPoints));
+  }
+}
+
 } // namespace ltests
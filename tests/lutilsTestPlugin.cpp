@@ -0,0 +1,26 @@
+/**
+ * \file lutilsTestPlugin.cpp
+ * \brief
+ *
+ * A shared library for the DynamicLibrary tests, built twice with different LTEST_PLUGIN_VERSION
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+#if defined(_WIN32)
+#define LTEST_EXPORT extern "C" __declspec(dllexport)
+#else
+#define LTEST_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+LTEST_EXPORT int ltestPluginVersion() {
+  return LTEST_PLUGIN_VERSION;
+}
+
+LTEST_EXPORT int ltestPluginApply(int value) {
+  return value * 10 + LTEST_PLUGIN_VERSION;
+}
@@ -0,0 +1,1264 @@
+﻿/**
+ * \file lutilsTests.cpp
+ * \brief
+ *
+ * lutils tests
+ *
+ * \version 1.0.0
+ * \date 18/10/2026
+ * \author Sergey Kosarevsky, 2026
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ * https://github.com/corporateshark/ldrutils
+ */
+
+// PROFILE_SCOPE() is tested regardless of the CMake option
+#if !defined(LMATH_ENABLE_PROFILING)
+#define LMATH_ENABLE_PROFILING 1
+#endif // LMATH_ENABLE_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include <lutils/Array2D.h>
+#include <lutils/Array2DParallel.h>
+#include <lutils/BitReader.h>
+#include <lutils/BitWriter.h>
+#include <lutils/ConcurrentQueue.h>
+#include <lutils/DynamicLibrary.h>
+#include <lutils/EntropyCoding.h>
+#include <lutils/MappedArray2D.h>
+#include <lutils/Profiler.h>
+#include <lutils/Ptr.h>
+#include <lutils/PtrUtils.h>
+#include <lutils/ThreadPool.h>
+
+// downstream code forward-declares the counter
+namespace ldr {
+class IntrusiveCounter;
+} // namespace ldr
+
+namespace ltests {
+
+namespace {
+
+template<class Base, class Counter = int>
+class Counted : public Base {
+ public:
+  explicit Counted(Counter* numAlive) : numAlive_(numAlive) {
+    (*numAlive_)++;
+  }
+  ~Counted() override {
+    (*numAlive_)--;
+  }
+
+ private:
+  Counter* numAlive_ = nullptr;
+};
+
+using CountedMT = Counted<ldr::IntrusiveCounter>;
+using CountedST = Counted<ldr::IntrusiveCounterSingleThreaded>;
+// objects created and destroyed concurrently on different threads
+using CountedAtomic = Counted<ldr::IntrusiveCounter, std::atomic<int>>;
+
+} // namespace
+
+GTEST_TEST(lutils, clPtr_refcount) {
+  int numAlive = 0;
+  {
+    clPtr<CountedMT> p1 = ldr::make_intrusive<CountedMT>(&numAlive);
+    ASSERT_EQ(numAlive, 1);
+    ASSERT_EQ(p1.useCount(), 1u);
+    {
+      clPtr<CountedMT> p2 = p1;
+      ASSERT_EQ(p1.useCount(), 2u);
+      clPtr<ldr::IntrusiveCounter> p3 = p2;
+      ASSERT_EQ(p1.useCount(), 3u);
+    }
+    ASSERT_EQ(p1.useCount(), 1u);
+    p1 = nullptr;
+    ASSERT_EQ(numAlive, 0);
+  }
+  ASSERT_EQ(numAlive, 0);
+}
+
+GTEST_TEST(lutils, clPtr_refcount_single_threaded) {
+  int numAlive = 0;
+  {
+    clPtr<CountedST> p1 = ldr::make_intrusive<CountedST>(&numAlive);
+    clPtr<CountedST> p2 = p1;
+    ASSERT_EQ(p1.useCount(), 2u);
+    p1 = p2;
+    ASSERT_EQ(p1.useCount(), 2u);
+    ASSERT_EQ(numAlive, 1);
+  }
+  ASSERT_EQ(numAlive, 0);
+}
+
+GTEST_TEST(lutils, clPtr_move) {
+  int numAlive = 0;
+  {
+    clPtr<CountedMT> p1 = ldr::make_intrusive<CountedMT>(&numAlive);
+    clPtr<CountedMT> p2 = std::move(p1);
+    ASSERT_FALSE(p1);
+    ASSERT_EQ(p2.useCount(), 1u);
+    clPtr<ldr::IntrusiveCounter> p3 = std::move(p2);
+    ASSERT_FALSE(p2);
+    ASSERT_EQ(p3.useCount(), 1u);
+    clPtr<CountedMT> p4 = ldr::make_intrusive<CountedMT>(&numAlive);
+    ASSERT_EQ(numAlive, 2);
+    p4 = clPtr<CountedMT>(p4);
+    ASSERT_EQ(p4.useCount(), 1u);
+    swap(p1, p4);
+    ASSERT_TRUE(p1);
+    ASSERT_FALSE(p4);
+    p1.reset();
+    ASSERT_EQ(numAlive, 1);
+    CountedMT* raw = clPtr<CountedMT>(new CountedMT(&numAlive)).release();
+    ASSERT_EQ(raw->useCount(), 1u);
+    p4 = clPtr<CountedMT>::adopt(raw);
+    ASSERT_EQ(p4.useCount(), 1u);
+    ASSERT_EQ(numAlive, 2);
+  }
+  ASSERT_EQ(numAlive, 0);
+}
+
+GTEST_TEST(lutils, clPtr_vector_growth) {
+  int numAlive = 0;
+  {
+    static_assert(std::is_nothrow_move_constructible_v<clPtr<CountedMT>>);
+    std::vector<clPtr<CountedMT>> v;
+    for (int i = 0; i != 100; i++) {
+      v.push_back(ldr::make_intrusive<CountedMT>(&numAlive));
+    }
+    for (const auto& p : v) {
+      ASSERT_EQ(p.useCount(), 1u);
+    }
+    ASSERT_EQ(numAlive, 100);
+  }
+  ASSERT_EQ(numAlive, 0);
+}
+
+GTEST_TEST(lutils, clPtr_pooled) {
+  int numAlive = 0;
+  CountedMT* prev = nullptr;
+  for (int i = 0; i != 3; i++) {
+    clPtr<CountedMT> p = ldr::make_intrusive_pooled<CountedMT>(&numAlive);
+    ASSERT_EQ(numAlive, 1);
+    // the block released by the previous iteration is reused immediately
+    if (prev) {
+      ASSERT_EQ(p.get(), prev);
+    }
+    prev = p.get();
+  }
+  ASSERT_EQ(numAlive, 0);
+
+  std::vector<clPtr<CountedST>> v;
+  for (int i = 0; i != 10000; i++) {
+    v.push_back(ldr::make_intrusive_pooled<CountedST>(&numAlive));
+  }
+  ASSERT_EQ(numAlive, 10000);
+  v.clear();
+  ASSERT_EQ(numAlive, 0);
+
+  // a thread_local destroyed after the pool's own thread_local cache still frees into the pool
+  std::thread([&numAlive]() {
+    struct Holder {
+      clPtr<CountedMT> p;
+    };
+    thread_local Holder holder;
+    ldr::make_intrusive_pooled<CountedMT>(&numAlive).reset();
+    holder.p = ldr::make_intrusive_pooled<CountedMT>(&numAlive);
+  }).join();
+  ASSERT_EQ(numAlive, 0);
+}
+
+namespace {
+
+class CountedFinal final : public CountedMT {
+ public:
+  using CountedMT::CountedMT;
+};
+
+template<class T>
+struct CountingAllocator {
+  using value_type = T;
+  int* numAllocations = nullptr;
+  explicit CountingAllocator(int* n) : numAllocations(n) {}
+  template<class U>
+  CountingAllocator(const CountingAllocator<U>& other) : numAllocations(other.numAllocations) {}
+  T* allocate(size_t n) {
+    (*numAllocations)++;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) {
+    (*numAllocations)--;
+    std::allocator<T>().deallocate(p, n);
+  }
+};
+
+} // namespace
+
+GTEST_TEST(lutils, clPtr_allocate_intrusive) {
+  int numAlive = 0;
+  int numAllocations = 0;
+  {
+    clPtr<CountedMT> p = ldr::allocate_intrusive<CountedMT>(CountingAllocator<CountedMT>(&numAllocations), &numAlive);
+    ASSERT_EQ(numAllocations, 1);
+    ASSERT_EQ(numAlive, 1);
+  }
+  ASSERT_EQ(numAllocations, 0);
+  ASSERT_EQ(numAlive, 0);
+
+  // the object is not wrapped: final classes work and the dynamic type is exact
+  {
+    clPtr<CountedMT> p = ldr::allocate_intrusive<CountedFinal>(CountingAllocator<CountedFinal>(&numAllocations), &numAlive);
+    ASSERT_TRUE(typeid(p.getRef()) == typeid(CountedFinal));
+    ASSERT_TRUE(p.DynamicCast<CountedFinal>());
+    ASSERT_EQ(numAllocations, 1);
+  }
+  ASSERT_EQ(numAllocations, 0);
+  ASSERT_EQ(numAlive, 0);
+}
+
+GTEST_TEST(lutils, clWeakPtr_lock) {
+  int numAlive = 0;
+  clWeakPtr<CountedMT> w1;
+  ASSERT_TRUE(w1.expired());
+  ASSERT_FALSE(w1.lock());
+  {
+    clPtr<CountedMT> p = ldr::make_intrusive<CountedMT>(&numAlive);
+    w1 = p;
+    clWeakPtr<ldr::IntrusiveCounter> w2 = clPtr<ldr::IntrusiveCounter>(p);
+    ASSERT_EQ(p.useCount(), 1u);
+    ASSERT_FALSE(w1.expired());
+    {
+      clPtr<CountedMT> locked = w1.lock();
+      ASSERT_EQ(locked, p);
+      ASSERT_EQ(p.useCount(), 2u);
+    }
+    ASSERT_EQ(p.useCount(), 1u);
+    ASSERT_EQ(numAlive, 1);
+  }
+  ASSERT_EQ(numAlive, 0);
+  ASSERT_TRUE(w1.expired());
+  ASSERT_FALSE(w1.lock());
+
+  clPtr<CountedST> p = ldr::make_intrusive<CountedST>(&numAlive);
+  clWeakPtr<CountedST> w3 = p;
+  clWeakPtr<CountedST> w4 = w3;
+  ASSERT_EQ(w4.lock(), p);
+  p = nullptr;
+  ASSERT_EQ(numAlive, 0);
+  ASSERT_FALSE(w4.lock());
+}
+
+GTEST_TEST(lutils, clWeakPtr_threads) {
+  int numAlive = 0;
+  for (int i = 0; i != 100; i++) {
+    clPtr<CountedMT> p = ldr::make_intrusive<CountedMT>(&numAlive);
+    clWeakPtr<CountedMT> w = p;
+    std::thread t([w]() {
+      // the last reference can be dropped either here or in the main thread
+      while (clPtr<CountedMT> locked = w.lock()) {
+      }
+    });
+    p = nullptr;
+    t.join();
+    ASSERT_TRUE(w.expired());
+  }
+  ASSERT_EQ(numAlive, 0);
+}
+
+GTEST_TEST(lutils, clPtr_deferred_reclamation) {
+  int numAlive = 0;
+  ldr::DeferredReclamation::collect();
+  {
+    ldr::DeferredReclamationScope scope;
+    for (int i = 0; i != 100; i++) {
+      ldr::make_intrusive<CountedMT>(&numAlive);
+    }
+    ASSERT_EQ(numAlive, 100);
+  }
+  ASSERT_EQ(numAlive, 100);
+  ASSERT_EQ(ldr::DeferredReclamation::collect(), 100u);
+  ASSERT_EQ(numAlive, 0);
+
+  // a safe point inside the scope also reclaims the partial batch of the calling thread
+  {
+    ldr::DeferredReclamationScope scope;
+    ldr::make_intrusive<CountedMT>(&numAlive);
+    ASSERT_EQ(numAlive, 1);
+    ASSERT_EQ(ldr::DeferredReclamation::collect(), 1u);
+    ASSERT_EQ(numAlive, 0);
+  }
+
+  std::atomic<int> numAliveAtomic = 0;
+  ldr::DeferredReclamation::startBackgroundThread(1);
+  {
+    ldr::DeferredReclamationScope scope;
+    ldr::make_intrusive<CountedAtomic>(&numAliveAtomic);
+  }
+  for (int i = 0; i != 5000 && numAliveAtomic; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ldr::DeferredReclamation::stopBackgroundThread();
+  ASSERT_EQ(numAliveAtomic, 0);
+}
+
+GTEST_TEST(lutils, clAtomicPtr) {
+  std::atomic<int> numAlive = 0;
+  {
+    ldr::clAtomicPtr<CountedAtomic> slot(ldr::make_intrusive<CountedAtomic>(&numAlive));
+    clPtr<CountedAtomic> p1 = slot.load();
+    // the slot's own reference, the loaded one and the donated ones which readers have not taken yet
+    ASSERT_EQ(p1.useCount(), 1u + ldr::clAtomicPtr<CountedAtomic>::kNumDonatedRefs);
+    // topping up the donation keeps the count bounded
+    for (uint32_t i = 0; i != 10 * ldr::clAtomicPtr<CountedAtomic>::kNumDonatedRefs; i++) {
+      ASSERT_EQ(slot.load(), p1);
+    }
+    ASSERT_LE(p1.useCount(), 1u + 2 * ldr::clAtomicPtr<CountedAtomic>::kNumDonatedRefs);
+    clPtr<CountedAtomic> p2 = ldr::make_intrusive<CountedAtomic>(&numAlive);
+    ASSERT_EQ(slot.exchange(p2), p1);
+    ASSERT_EQ(p1.useCount(), 1u);
+    ASSERT_FALSE(slot.compareExchange(p1, nullptr));
+    ASSERT_EQ(p1, p2);
+    ASSERT_TRUE(slot.compareExchange(p1, nullptr));
+    ASSERT_FALSE(slot.load());
+    p1 = nullptr;
+    p2 = nullptr;
+    ASSERT_EQ(numAlive, 0);
+
+    std::thread writer([&slot, &numAlive]() {
+      for (int i = 0; i != 10000; i++) {
+        slot.store(ldr::make_intrusive<CountedAtomic>(&numAlive));
+      }
+    });
+    for (int i = 0; i != 10000; i++) {
+      if (clPtr<CountedAtomic> p = slot.load()) {
+        // no ASSERT_* here: returning early would destroy the joinable `writer`
+        EXPECT_GE(p.useCount(), 1u);
+      }
+    }
+    writer.join();
+  }
+  ASSERT_EQ(numAlive, 0);
+}
+
+template<class Layout>
+void testArray2DLayout(size_t w, size_t h) {
+  ldr::Array2D<std::vector<int>, Layout> arr(w, h);
+  ASSERT_GE(arr.getLayout().getSize(), w * h);
+
+  std::vector<bool> used(arr.getLayout().getSize(), false);
+  for (size_t j = 0; j != h; j++) {
+    for (size_t i = 0; i != w; i++) {
+      const size_t idx = arr.getLayout().getIndex(i, j);
+      ASSERT_LT(idx, used.size());
+      ASSERT_FALSE(used[idx]);
+      used[idx] = true;
+      arr(i, j) = static_cast<int>(j * w + i);
+    }
+  }
+
+  std::vector<int> visited(w * h, 0);
+  arr.forEachTile([&](size_t i0, size_t j0, size_t i1, size_t j1) {
+    for (size_t j = j0; j != j1; j++) {
+      for (size_t i = i0; i != i1; i++) {
+        ASSERT_EQ(arr.at(i, j), static_cast<int>(j * w + i));
+        visited[j * w + i]++;
+      }
+    }
+  });
+  for (int v : visited) {
+    ASSERT_EQ(v, 1);
+  }
+
+  // blocks of the tiled and Morton layouts occupy disjoint ranges of indices
+  if constexpr (!std::is_same_v<Layout, ldr::Array2DLinearLayout>) {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    arr.forEachTile([&](size_t i0, size_t j0, size_t i1, size_t j1) {
+      std::pair<size_t, size_t> range(SIZE_MAX, 0);
+      for (size_t j = j0; j != j1; j++) {
+        for (size_t i = i0; i != i1; i++) {
+          range.first = std::min(range.first, arr.getLayout().getIndex(i, j));
+          range.second = std::max(range.second, arr.getLayout().getIndex(i, j));
+        }
+      }
+      ranges.push_back(range);
+    });
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t r = 1; r < ranges.size(); r++) {
+      ASSERT_LT(ranges[r - 1].second, ranges[r].first);
+    }
+  }
+}
+
+GTEST_TEST(lutils, Array2D_layouts) {
+  ASSERT_EQ(ldr::mortonEncode2D(3, 5), 39u);
+  ASSERT_EQ(ldr::mortonEncode2D(0xFFFFFFFFu, 0), 0x5555555555555555ull);
+
+  for (const auto& [w, h] : {std::pair<size_t, size_t>(1, 1), {37, 130}, {130, 37}, {256, 256}, {100, 1}}) {
+    testArray2DLayout<ldr::Array2DLinearLayout>(w, h);
+    testArray2DLayout<ldr::Array2DTiledLayout<>>(w, h);
+    testArray2DLayout<ldr::Array2DTiledLayout<8, 4>>(w, h);
+    testArray2DLayout<ldr::Array2DMortonLayout>(w, h);
+  }
+
+  // a square Morton block is contiguous
+  ldr::Array2D<std::vector<bool>, ldr::Array2DMortonLayout> bits(64, 64);
+  const ldr::Array2DMortonLayout& layout = bits.getLayout();
+  ASSERT_EQ(layout.getIndex(16, 16), 16u * 16u * 3u);
+  ASSERT_EQ(layout.getIndex(31, 31), 16u * 16u * 4u - 1u);
+  bits.set(5, 7, true);
+  ASSERT_TRUE(bits.at(5, 7));
+}
+
+GTEST_TEST(lutils, Array2D_rows) {
+  using Container = std::vector<float, ldr::AlignedAllocator<float, 64>>;
+
+  const size_t w = 37;
+  const size_t h = 19;
+  const size_t stride = ldr::Array2DLinearLayout::alignStride(w, sizeof(float), 64);
+  ASSERT_EQ(stride, 48u);
+  ASSERT_EQ(ldr::Array2DLinearLayout::alignStride(5, 12, 16), 8u);
+
+  ldr::Array2D<Container> arr(w, h, ldr::Array2DLinearLayout(w, h, stride));
+  ASSERT_EQ(arr.getStride(), stride);
+  for (size_t j = 0; j != h; j++) {
+    std::span<float> row = arr.row(j);
+    ASSERT_EQ(row.size(), w);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(row.data()) % 64, 0u);
+    for (size_t i = 0; i != w; i++) {
+      row[i] = static_cast<float>(j * w + i);
+    }
+  }
+  ASSERT_EQ(arr(5, 3), 3.0f * w + 5.0f);
+  ASSERT_EQ(arr.data()[3 * stride + 5], arr(5, 3));
+
+  ldr::parallelForRows(
+      arr,
+      [&arr](size_t j0, size_t j1) {
+        for (size_t j = j0; j != j1; j++) {
+          for (float& v : arr.row(j)) {
+            v *= 2.0f;
+          }
+        }
+      },
+      4);
+  ASSERT_EQ(arr(w - 1, h - 1), 2.0f * (w * h - 1));
+
+  ldr::Array2D<std::vector<int>, ldr::Array2DTiledLayout<8, 8>> tiled(100, 30);
+  std::atomic<int> numTiles = 0;
+  ldr::parallelForTiles(
+      tiled,
+      [&](size_t i0, size_t j0, size_t i1, size_t j1) {
+        numTiles++;
+        for (size_t j = j0; j != j1; j++) {
+          for (size_t i = i0; i != i1; i++) {
+            tiled(i, j)++;
+          }
+        }
+      },
+      3);
+  ASSERT_EQ(numTiles, 13 * 4);
+  for (size_t j = 0; j != 30; j++) {
+    for (size_t i = 0; i != 100; i++) {
+      ASSERT_EQ(tiled(i, j), 1);
+    }
+  }
+}
+
+GTEST_TEST(lutils, MappedArray2D) {
+  const std::string fileName = (std::filesystem::temp_directory_path() / "lutils_mapped_array2d.bin").string();
+
+  const size_t w = 300;
+  const size_t h = 200;
+  const uint32_t kTypeHeight = 0x48474854;
+  {
+    auto grid = ldr::createMappedArray2D<uint16_t>(fileName.c_str(), w, h, kTypeHeight);
+    ASSERT_TRUE(grid.has_value());
+    ASSERT_EQ(grid->at(7, 9), 0);
+    for (size_t j = 0; j != h; j++) {
+      for (size_t i = 0; i != w; i++) {
+        (*grid)(i, j) = static_cast<uint16_t>(i * j);
+      }
+    }
+  }
+  ASSERT_EQ(std::filesystem::file_size(fileName), 64 + w * h * sizeof(uint16_t));
+  {
+    auto grid = ldr::openMappedArray2D<uint16_t>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly, kTypeHeight);
+    ASSERT_TRUE(grid.has_value());
+    ASSERT_EQ(grid->getWidth(), w);
+    ASSERT_EQ(grid->getHeight(), h);
+    ASSERT_EQ(grid->at(299, 199), static_cast<uint16_t>(299 * 199));
+    ASSERT_EQ(grid->row(10)[20], 200);
+  }
+  // type and layout checks
+  ASSERT_FALSE(ldr::openMappedArray2D<uint16_t>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly, 0).has_value());
+  ASSERT_FALSE(ldr::openMappedArray2D<uint32_t>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly, kTypeHeight).has_value());
+  ASSERT_FALSE((ldr::openMappedArray2D<uint16_t, ldr::Array2DMortonLayout>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly, kTypeHeight)
+                    .has_value()));
+
+  std::filesystem::remove(fileName);
+  ASSERT_FALSE(ldr::openMappedArray2D<uint16_t>(fileName.c_str(), ldr::eMappedFileMode_ReadWrite).has_value());
+
+  // same number of elements, different layouts
+  ASSERT_TRUE(ldr::createMappedArray2D<uint8_t>(fileName.c_str(), 1024, 1024).has_value());
+  ASSERT_TRUE(ldr::openMappedArray2D<uint8_t>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly).has_value());
+  ASSERT_FALSE((ldr::openMappedArray2D<uint8_t, ldr::Array2DMortonLayout>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly).has_value()));
+  ASSERT_FALSE((ldr::openMappedArray2D<uint8_t, ldr::Array2DTiledLayout<>>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly).has_value()));
+  ASSERT_TRUE((ldr::createMappedArray2D<uint8_t, ldr::Array2DTiledLayout<>>(fileName.c_str(), 1024, 1024).has_value()));
+  ASSERT_FALSE((ldr::openMappedArray2D<uint8_t, ldr::Array2DTiledLayout<16, 64>>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly).has_value()));
+  ASSERT_TRUE((ldr::openMappedArray2D<uint8_t, ldr::Array2DTiledLayout<>>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly).has_value()));
+
+  // a corrupted data offset cannot wrap the size check around
+  ASSERT_TRUE(ldr::createMappedArray2D<uint64_t>(fileName.c_str(), 16, 16).has_value());
+  {
+    FILE* f = fopen(fileName.c_str(), "r+b");
+    ASSERT_TRUE(f);
+    const uint64_t dataOffset = UINT64_MAX - 7;
+    fseek(f, offsetof(ldr::Array2DFileHeader, dataOffset), SEEK_SET);
+    fwrite(&dataOffset, sizeof(dataOffset), 1, f);
+    fclose(f);
+  }
+  ASSERT_FALSE(ldr::openMappedArray2D<uint64_t>(fileName.c_str(), ldr::eMappedFileMode_ReadOnly).has_value());
+  std::filesystem::remove(fileName);
+}
+
+GTEST_TEST(lutils, BitWriter_BitReader) {
+  // (value, numBits) pairs with every width from 0 to 32
+  std::vector<std::pair<uint32_t, uint32_t>> codes;
+  uint32_t seed = 12345;
+  for (int i = 0; i != 2000; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    const uint32_t numBits = (seed >> 8) % 33;
+    const uint32_t mask = numBits == 32 ? ~0u : (1u << numBits) - 1u;
+    codes.emplace_back(seed * 2654435761u & mask, numBits);
+  }
+
+  // the reference implementation writes bit by bit into a zeroed buffer
+  std::vector<uint8_t> expected(8 * 1024, 0);
+  uint64_t bitPos = 0;
+  for (const auto& [bits, numBits] : codes) {
+    for (uint32_t n = numBits; n-- > 0; bitPos++) {
+      expected[bitPos >> 3] |= ((bits >> n) & 1) << (7 - (bitPos & 7));
+    }
+  }
+  const size_t numBytes = (bitPos + 7) >> 3;
+
+  // garbage in the output buffer should be overwritten
+  std::vector<uint8_t> buf(numBytes, 0xAB);
+  {
+    ldr::BitWriter writer(buf.data(), static_cast<uint32_t>(buf.size()));
+    for (const auto& [bits, numBits] : codes) {
+      writer.writeBits(bits, numBits);
+    }
+    ASSERT_EQ(writer.getNumBits(), bitPos);
+    ASSERT_EQ(writer.getNumBytes(), numBytes);
+  }
+  ASSERT_TRUE(std::equal(buf.begin(), buf.end(), expected.begin()));
+
+  ldr::BitReader reader(buf.data(), buf.size());
+  for (const auto& [bits, numBits] : codes) {
+    ASSERT_EQ(reader.peekBits(numBits), bits);
+    ASSERT_EQ(reader.readBits(numBits), bits);
+  }
+  ASSERT_EQ(reader.getNumBits(), bitPos);
+  ASSERT_FALSE(reader.isOverrun());
+  ASSERT_EQ(reader.readBits(32), 0u);
+  ASSERT_TRUE(reader.isOverrun());
+
+  // flush() in the middle of a byte
+  uint8_t small[3] = {0xFF, 0xFF, 0xFF};
+  {
+    ldr::BitWriter writer(small, sizeof(small));
+    writer.writeBits(0b101, 3);
+    writer.flush();
+    ASSERT_EQ(small[0], 0b10100000);
+    writer.writeBits(0x1FFFF, 17);
+  }
+  ASSERT_EQ(small[0], 0b10111111);
+  ASSERT_EQ(small[1], 0xFF);
+  ASSERT_EQ(small[2], 0xF0);
+
+  // growable and streaming sinks produce the same bytes
+  std::vector<uint8_t> vec = {42};
+  std::vector<uint8_t> streamed;
+  size_t maxChunk = 0;
+  {
+    ldr::BitWriterVector vectorWriter(vec);
+    ldr::BitWriterStream<64> streamWriter([&](const uint8_t* data, size_t size) {
+      streamed.insert(streamed.end(), data, data + size);
+      maxChunk = std::max(maxChunk, size);
+    });
+    for (const auto& [bits, numBits] : codes) {
+      vectorWriter.writeBits(bits, numBits);
+      streamWriter.writeBits(bits, numBits);
+    }
+    vectorWriter.flush();
+    ASSERT_EQ(vec.size(), 1 + numBytes);
+  }
+  ASSERT_EQ(vec.size(), 1 + numBytes);
+  ASSERT_EQ(vec[0], 42);
+  ASSERT_TRUE(std::equal(buf.begin(), buf.end(), vec.begin() + 1));
+  ASSERT_EQ(streamed, buf);
+  ASSERT_EQ(maxChunk, 64u);
+}
+
+GTEST_TEST(lutils, EntropyCoding_universalCodes) {
+  const uint32_t values[] = {1, 2, 3, 7, 8, 255, 256, 1000, 65535, 1u << 20, 0x7FFFFFFF, 0xFFFFFFFF};
+  std::vector<uint8_t> buf;
+  {
+    ldr::BitWriterVector writer(buf);
+    for (uint32_t v : values) {
+      ldr::writeEliasGamma(writer, v);
+      ldr::writeGolombRice(writer, v % 5000, 4);
+      ldr::writeVarint(writer, ldr::zigZagEncode(-int64_t(v)));
+    }
+  }
+  ldr::BitReader reader(buf.data(), buf.size());
+  for (uint32_t v : values) {
+    ASSERT_EQ(ldr::readEliasGamma(reader), v);
+    ASSERT_EQ(ldr::readGolombRice(reader, 4), v % 5000);
+    ASSERT_EQ(ldr::zigZagDecode(ldr::readVarint(reader)), -int64_t(v));
+  }
+  ASSERT_FALSE(reader.isOverrun());
+
+  // Elias-gamma of 1 is a single bit
+  uint8_t one = 0xFF;
+  {
+    ldr::BitWriter writer(&one, 1);
+    ldr::writeEliasGamma(writer, 1);
+    ASSERT_EQ(writer.getNumBits(), 1u);
+  }
+  ASSERT_EQ(one, 0x80);
+
+  uint8_t bytes[10];
+  ASSERT_EQ(ldr::encodeVarint(300, bytes), 2u);
+  ASSERT_EQ(bytes[0], 0xAC);
+  ASSERT_EQ(bytes[1], 0x02);
+  ASSERT_EQ(ldr::encodeVarint(~uint64_t(0), bytes), 10u);
+  uint64_t value = 0;
+  ASSERT_EQ(ldr::decodeVarint(bytes, 10, value), 10u);
+  ASSERT_EQ(value, ~uint64_t(0));
+  ASSERT_EQ(ldr::decodeVarint(bytes, 9, value), 0u);
+}
+
+GTEST_TEST(lutils, EntropyCoding_Huffman) {
+  // a skewed alphabet: symbol s appears ~ 1/(s+1)^2 times
+  std::vector<uint16_t> symbols;
+  uint32_t seed = 777;
+  for (int i = 0; i != 20000; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    const double u = (seed >> 8) / double(1 << 24);
+    symbols.push_back(static_cast<uint16_t>(std::min(299.0, 1.0 / (1.0 - u * 0.999) - 1.0)));
+  }
+  std::vector<uint32_t> freq(300, 0);
+  for (uint16_t s : symbols) {
+    freq[s]++;
+  }
+
+  for (uint32_t maxLength : {9u, 12u}) {
+    const ldr::HuffmanCodec codec(freq, maxLength);
+    uint32_t maxLen = 0;
+    for (uint8_t len : codec.getCodeLengths()) {
+      maxLen = std::max<uint32_t>(maxLen, len);
+    }
+    ASSERT_LE(maxLen, maxLength);
+
+    std::vector<uint8_t> buf;
+    {
+      ldr::BitWriterVector writer(buf);
+      for (uint16_t s : symbols) {
+        codec.encode(writer, s);
+      }
+      ASSERT_EQ(writer.getNumBits(), codec.getEncodedSize(freq));
+    }
+    // better than 9 bits per symbol of the raw encoding
+    ASSERT_LT(buf.size(), symbols.size() * 9 / 8 / 2);
+
+    const ldr::HuffmanCodec decoder = ldr::HuffmanCodec::fromCodeLengths(codec.getCodeLengths());
+    ldr::BitReader reader(buf.data(), buf.size());
+    for (uint16_t s : symbols) {
+      ASSERT_EQ(decoder.decode(reader), s);
+    }
+  }
+
+  // a single used symbol
+  const uint32_t single[4] = {0, 0, 5, 0};
+  const ldr::HuffmanCodec codec(single);
+  ASSERT_EQ(codec.getCodeLengths()[2], 1);
+}
+
+GTEST_TEST(lutils, EntropyCoding_rANS) {
+  std::vector<uint8_t> symbols;
+  uint32_t seed = 4242;
+  for (int i = 0; i != 50001; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    // mostly small values
+    symbols.push_back(static_cast<uint8_t>((seed >> 24) & ((seed & 0x300) ? 7 : 255)));
+  }
+  std::vector<uint32_t> freq(256, 0);
+  for (uint8_t s : symbols) {
+    freq[s]++;
+  }
+
+  const ldr::RansModel model(freq, 14);
+  uint32_t sum = 0;
+  for (int s = 0; s != 256; s++) {
+    sum += model.getFrequency(uint8_t(s));
+    ASSERT_EQ(model.getFrequency(uint8_t(s)) != 0, freq[s] != 0);
+  }
+  ASSERT_EQ(sum, 1u << 14);
+
+  const std::vector<uint8_t> encoded = ldr::ransEncode<4>(symbols, model);
+  ASSERT_LT(encoded.size(), symbols.size() * 3 / 4);
+
+  std::vector<uint8_t> decoded(symbols.size());
+  ASSERT_TRUE(ldr::ransDecode<4>(encoded, decoded, model));
+  ASSERT_EQ(decoded, symbols);
+
+  // a different number of states is a different stream
+  const std::vector<uint8_t> encoded1 = ldr::ransEncode<1>(symbols, model);
+  ASSERT_TRUE(ldr::ransDecode<1>(encoded1, decoded, model));
+  ASSERT_EQ(decoded, symbols);
+
+  ASSERT_FALSE(ldr::ransDecode<4>(std::span(encoded).first(encoded.size() / 2), decoded, model));
+}
+
+GTEST_TEST(lutils, DynamicLibrary) {
+#if defined(_WIN32)
+  const char* libName = "kernel32.dll";
+  const char* procNames[] = {"GetTickCount", "GetCurrentProcessId"};
+#elif defined(__APPLE__)
+  const char* libName = "libSystem.B.dylib";
+  const char* procNames[] = {"getpid", "strlen"};
+#else
+  const char* libName = "libc.so.6";
+  const char* procNames[] = {"getpid", "strlen"};
+#endif
+
+  ldr::DynamicLibrary lib;
+  ASSERT_FALSE(lib.isLoaded());
+  ASSERT_EQ(lib.getProcAddress(procNames[0]), nullptr);
+  ASSERT_FALSE(lib.load("lutils_no_such_library", ldr::eDynamicLibraryFlags_Now));
+  ASSERT_FALSE(lib.isLoaded());
+
+  // the C runtime is already loaded into the test process
+  ASSERT_TRUE(lib.load(libName, ldr::eDynamicLibraryFlags_Now | ldr::eDynamicLibraryFlags_NoLoad));
+  ASSERT_TRUE(lib.isLoaded());
+
+  void* proc0 = nullptr;
+  void* proc1 = nullptr;
+  void* missing = reinterpret_cast<void*>(&lib);
+
+  const ldr::DynamicLibrarySymbol symbols[] = {
+      {procNames[0], &proc0},
+      {procNames[1], &proc1},
+      {"lutils_no_such_symbol", &missing, true},
+  };
+  ASSERT_TRUE(lib.bindSymbols(symbols));
+  ASSERT_NE(proc0, nullptr);
+  ASSERT_NE(proc1, nullptr);
+  ASSERT_EQ(missing, nullptr);
+
+  const ldr::DynamicLibrarySymbol required[] = {{"lutils_no_such_symbol", &missing}};
+  ASSERT_FALSE(lib.bindSymbols(required));
+
+  // the second lookups are served from the cache
+  ASSERT_EQ(lib.getProcAddress(procNames[0]), proc0);
+  ASSERT_EQ(lib.getProcAddress(procNames[1]), proc1);
+
+  const ldr::DynamicLibraryStats stats = lib.getStats();
+  ASSERT_EQ(stats.numLookups, 6);
+  ASSERT_EQ(stats.numCacheHits, 3);
+  ASSERT_GE(stats.loadTimeMs, 0.0);
+  ASSERT_GE(stats.resolveTimeMs, 0.0);
+
+  lib.unload();
+  ASSERT_FALSE(lib.isLoaded());
+  ASSERT_EQ(lib.getStats().numLookups, 0);
+}
+
+#if defined(LTEST_PLUGIN_V1) && defined(LTEST_PLUGIN_V2)
+GTEST_TEST(lutils, DynamicLibrary_loadLibraries) {
+  // 0 <- 1 <- 3, 0 <- 2, 4 fails and takes 5 with it
+  std::vector<ldr::DynamicLibraryLoadRequest> requests = {
+      {LTEST_PLUGIN_V1, ldr::eDynamicLibraryFlags_Now, {}},
+      {LTEST_PLUGIN_V2, ldr::eDynamicLibraryFlags_Now, {0}},
+      {LTEST_PLUGIN_V1, ldr::eDynamicLibraryFlags_Lazy, {0}},
+      {LTEST_PLUGIN_V2, ldr::eDynamicLibraryFlags_Lazy, {1, 2}},
+      {"lutils_no_such_library", ldr::eDynamicLibraryFlags_Lazy, {}},
+      {LTEST_PLUGIN_V1, ldr::eDynamicLibraryFlags_Lazy, {4, 0}},
+  };
+  std::vector<ldr::DynamicLibrary> libraries(requests.size());
+  ldr::ThreadPool pool(2);
+  ASSERT_FALSE(ldr::loadLibraries(requests, libraries, pool));
+  for (size_t i = 0; i != 4; i++) {
+    ASSERT_TRUE(libraries[i].isLoaded()) << i;
+  }
+  ASSERT_FALSE(libraries[4].isLoaded());
+  ASSERT_FALSE(libraries[5].isLoaded());
+  ASSERT_EQ(libraries[3].getProc<int()>("ltestPluginVersion")(), 2);
+
+  requests.resize(4);
+  std::vector<ldr::DynamicLibrary> libraries2(requests.size());
+  ASSERT_TRUE(ldr::loadLibraries(requests, libraries2));
+  ASSERT_EQ(libraries2[2].getProc<int(int)>("ltestPluginApply")(4), 41);
+
+  // cycles are rejected up front
+  requests[0].dependencies = {3};
+  std::vector<ldr::DynamicLibrary> libraries3(requests.size());
+  ASSERT_FALSE(ldr::loadLibraries(requests, libraries3));
+  ASSERT_FALSE(libraries3[0].isLoaded());
+}
+
+GTEST_TEST(lutils, DynamicLibrary_hotReload) {
+  struct PluginTable {
+    int (*version)() = nullptr;
+    int (*apply)(int) = nullptr;
+  };
+
+  const std::filesystem::path fileName =
+      std::filesystem::temp_directory_path() / ("lutils_hot_reload" + std::filesystem::path(LTEST_PLUGIN_V1).extension().string());
+  std::filesystem::copy_file(LTEST_PLUGIN_V1, fileName, std::filesystem::copy_options::overwrite_existing);
+
+  ldr::HotReloadLibrary<PluginTable> plugin;
+  ASSERT_FALSE(plugin.acquire());
+  ASSERT_TRUE(plugin.load(fileName.string().c_str(), [](PluginTable& t) {
+    return std::vector<ldr::DynamicLibrarySymbol>{
+        ldr::makeDynamicLibrarySymbol("ltestPluginVersion", t.version),
+        ldr::makeDynamicLibrarySymbol("ltestPluginApply", t.apply),
+    };
+  }));
+  ASSERT_FALSE(plugin.poll());
+
+  auto inFlight = plugin.acquire();
+  ASSERT_TRUE(inFlight);
+  ASSERT_EQ(inFlight->version(), 1);
+
+  // callers on other threads keep calling while the library is swapped
+  std::atomic<bool> stop = false;
+  std::atomic<uint32_t> numCalls = 0;
+  std::thread caller([&]() {
+    while (!stop) {
+      const auto p = plugin.acquire();
+      const int v = p->version();
+      EXPECT_EQ(p->apply(1), 10 + v);
+      numCalls++;
+    }
+  });
+
+  std::filesystem::copy_file(LTEST_PLUGIN_V2, fileName, std::filesystem::copy_options::overwrite_existing);
+  ASSERT_TRUE(plugin.poll());
+  ASSERT_EQ(plugin.acquire()->version(), 2);
+  ASSERT_EQ(plugin.acquire().getGeneration(), 2);
+
+  // the old version is still loaded while a call is in flight
+  ASSERT_EQ(inFlight->apply(5), 51);
+  ASSERT_EQ(plugin.getNumLoadedVersions(), 2);
+  inFlight = {};
+
+  // retired versions are freed while the caller keeps acquiring
+  for (int i = 0; i != 4; i++) {
+    std::filesystem::copy_file(i & 1 ? LTEST_PLUGIN_V2 : LTEST_PLUGIN_V1, fileName, std::filesystem::copy_options::overwrite_existing);
+    ASSERT_TRUE(plugin.reload());
+    ASSERT_EQ(plugin.acquire()->version(), i & 1 ? 2 : 1);
+  }
+
+  const uint32_t numCallsBefore = numCalls;
+  while (numCalls < numCallsBefore + 100) {
+    std::this_thread::yield();
+  }
+  stop = true;
+  caller.join();
+
+  // the watcher may still report the copies above, any reload swaps in the same file
+  plugin.poll();
+  ASSERT_EQ(plugin.getNumLoadedVersions(), 1);
+  ASSERT_EQ(plugin.acquire()->version(), 2);
+
+  // unload() waits for calls in flight
+  std::atomic<bool> isHolding = false;
+  std::atomic<bool> isReleased = false;
+  std::thread holder([&]() {
+    auto p = plugin.acquire();
+    isHolding = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(p->apply(2), 22);
+    isReleased = true;
+  });
+  while (!isHolding) {
+    std::this_thread::yield();
+  }
+  plugin.unload();
+  ASSERT_TRUE(isReleased);
+  holder.join();
+  ASSERT_FALSE(plugin.acquire());
+  std::filesystem::remove(fileName);
+}
+#endif // LTEST_PLUGIN_V1 && LTEST_PLUGIN_V2
+
+GTEST_TEST(lutils, Profiler) {
+  ldr::Profiler::reset();
+
+  auto work = [](int numIterations) {
+    for (int i = 0; i != numIterations; i++) {
+      PROFILE_SCOPE("outer");
+      {
+        PROFILE_SCOPE("inner \"quoted\"");
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    }
+  };
+
+  std::thread thread(work, 3);
+  work(2);
+  thread.join();
+
+  const ldr::ProfileCapture capture = ldr::Profiler::capture();
+
+  ASSERT_EQ(capture.names.size(), 2);
+  ASSERT_EQ(capture.events.size(), 10);
+
+  const uint32_t outer = capture.names[0] == "outer" ? 0 : 1;
+
+  // thread indices keep growing across reset() calls (e.g. with --gtest_repeat), only their number is known
+  std::map<uint32_t, size_t> numEvents;
+  for (size_t i = 0; i != capture.events.size(); i++) {
+    const ldr::ProfileEvent& e = capture.events[i];
+    ASSERT_LT(e.nameIndex, 2);
+    if (i) {
+      ASSERT_LE(capture.events[i - 1].startNs, e.startNs);
+    }
+    numEvents[e.threadIndex]++;
+    // calibrated timestamps: every scope sleeps at least 200 us
+    ASSERT_GE(e.durationNs, 150000);
+    if (e.nameIndex == outer) {
+      // the inner scope on the same thread starts within the outer one and ends before it
+      const auto inner = std::find_if(capture.events.begin() + i + 1, capture.events.end(), [&](const ldr::ProfileEvent& x) {
+        return x.threadIndex == e.threadIndex;
+      });
+      ASSERT_NE(inner, capture.events.end());
+      ASSERT_NE(inner->nameIndex, outer);
+      ASSERT_LE(inner->startNs + inner->durationNs, e.startNs + e.durationNs);
+    }
+  }
+  ASSERT_EQ(numEvents.size(), 2);
+  const size_t numEventsFirst = numEvents.begin()->second;
+  ASSERT_TRUE(numEventsFirst == 4 || numEventsFirst == 6);
+  ASSERT_EQ(numEventsFirst + numEvents.rbegin()->second, 10);
+
+  const std::filesystem::path fileName = std::filesystem::temp_directory_path() / "lutils_profile.json";
+  ASSERT_TRUE(capture.saveChromeTrace(fileName.string().c_str()));
+  ASSERT_GT(std::filesystem::file_size(fileName), 0);
+  std::filesystem::remove(fileName);
+
+  const std::vector<uint8_t> binary = capture.toBinary();
+  ldr::ProfileCapture loaded;
+  ASSERT_TRUE(loaded.fromBinary(binary));
+  ASSERT_EQ(loaded.names, capture.names);
+  ASSERT_EQ(loaded.events.size(), capture.events.size());
+  for (size_t i = 0; i != capture.events.size(); i++) {
+    ASSERT_EQ(loaded.events[i].nameIndex, capture.events[i].nameIndex);
+    ASSERT_EQ(loaded.events[i].threadIndex, capture.events[i].threadIndex);
+    ASSERT_EQ(loaded.events[i].startNs, capture.events[i].startNs);
+    ASSERT_EQ(loaded.events[i].durationNs, capture.events[i].durationNs);
+  }
+  ASSERT_FALSE(loaded.fromBinary(std::span(binary).first(binary.size() - 1)));
+
+  ldr::Profiler::reset();
+  ASSERT_TRUE(ldr::Profiler::capture().events.empty());
+
+  // buffers of exited threads are kept until reset()
+  const size_t numBuffers = ldr::Profiler::getNumThreadBuffers();
+  for (int i = 0; i != 3; i++) {
+    std::thread([]() { PROFILE_SCOPE("short-lived"); }).join();
+  }
+  ASSERT_EQ(ldr::Profiler::getNumThreadBuffers(), numBuffers + 3);
+  ASSERT_EQ(ldr::Profiler::capture().events.size(), 3);
+  ldr::Profiler::reset();
+  ASSERT_EQ(ldr::Profiler::getNumThreadBuffers(), numBuffers);
+
+  // a thread_local destroyed after the profiler's own one records into a buffer which is orphaned right away
+  struct LateRecorder {
+    bool isArmed = false;
+    ~LateRecorder() {
+      if (isArmed) {
+        ldr::Profiler::record("late", ldr::Profiler::now(), ldr::Profiler::now());
+      }
+    }
+  };
+  std::thread([]() {
+    static thread_local LateRecorder lateRecorder;
+    lateRecorder.isArmed = true;
+    ldr::Profiler::record("early", ldr::Profiler::now(), ldr::Profiler::now());
+  }).join();
+  ASSERT_EQ(ldr::Profiler::getNumThreadBuffers(), numBuffers + 2);
+  ASSERT_EQ(ldr::Profiler::capture().events.size(), 2);
+  ldr::Profiler::reset();
+  ASSERT_EQ(ldr::Profiler::getNumThreadBuffers(), numBuffers);
+}
+
+GTEST_TEST(lutils, SPSCQueue) {
+  ldr::SPSCQueue<int> queue(5);
+  ASSERT_EQ(queue.capacity(), 8);
+
+  int value = 0;
+  ASSERT_FALSE(queue.tryPop(value));
+  for (int i = 0; i != 8; i++) {
+    ASSERT_TRUE(queue.tryPush(i));
+  }
+  ASSERT_FALSE(queue.tryPush(8));
+  ASSERT_TRUE(queue.tryPop(value));
+  ASSERT_EQ(value, 0);
+  int batch[4] = {};
+  ASSERT_EQ(queue.tryPopBatch(batch), 4);
+  ASSERT_EQ(batch[3], 4);
+  int more[6] = {10, 11, 12, 13, 14, 15};
+  ASSERT_EQ(queue.tryPushBatch(more), 5);
+  ASSERT_EQ(queue.size(), 8);
+
+  // ordered handoff between two threads, mixing single and batch operations
+  constexpr int kNumValues = 200000;
+  ldr::SPSCQueue<int> handoff(64);
+
+  std::thread producer([&handoff]() {
+    int next = 0;
+    while (next != kNumValues) {
+      if (next % 3) {
+        if (handoff.tryPush(next)) {
+          next++;
+        } else {
+          std::this_thread::yield();
+        }
+      } else {
+        int values[16];
+        const int n = std::min(16, kNumValues - next);
+        for (int i = 0; i != n; i++) {
+          values[i] = next + i;
+        }
+        const size_t numPushed = handoff.tryPushBatch(std::span(values, n));
+        if (!numPushed) {
+          std::this_thread::yield();
+        }
+        next += static_cast<int>(numPushed);
+      }
+    }
+  });
+
+  int expected = 0;
+  bool isOrdered = true;
+  while (expected != kNumValues) {
+    int values[7];
+    const size_t n = handoff.tryPopBatch(values);
+    if (!n) {
+      std::this_thread::yield();
+    }
+    for (size_t i = 0; i != n; i++) {
+      isOrdered &= values[i] == expected++;
+    }
+  }
+  producer.join();
+  ASSERT_TRUE(isOrdered);
+  ASSERT_TRUE(handoff.empty());
+}
+
+GTEST_TEST(lutils, MPMCQueue) {
+  ldr::MPMCQueue<int> queue(4);
+  ASSERT_EQ(queue.capacity(), 4);
+
+  int values[6] = {1, 2, 3, 4, 5, 6};
+  ASSERT_EQ(queue.tryPushBatch(values), 4);
+  ASSERT_FALSE(queue.tryPush(5));
+  int value = 0;
+  ASSERT_TRUE(queue.tryPop(value));
+  ASSERT_EQ(value, 1);
+  ASSERT_TRUE(queue.tryPush(5));
+  int popped[8] = {};
+  ASSERT_EQ(queue.tryPopBatch(popped), 4);
+  ASSERT_EQ(popped[0], 2);
+  ASSERT_EQ(popped[3], 5);
+  ASSERT_FALSE(queue.tryPop(value));
+
+  // every value is delivered exactly once
+  constexpr int kNumThreads = 3;
+  constexpr int kNumValuesPerThread = 50000;
+  ldr::MPMCQueue<int> shared(32);
+  std::vector<std::atomic<int>> numReceived(kNumThreads * kNumValuesPerThread);
+  std::atomic<int> numPopped = 0;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i != kNumValuesPerThread;) {
+        if (i % 2) {
+          if (shared.tryPush(t * kNumValuesPerThread + i)) {
+            i++;
+          } else {
+            std::this_thread::yield();
+          }
+        } else {
+          int batch[5];
+          const int n = std::min(5, kNumValuesPerThread - i);
+          for (int j = 0; j != n; j++) {
+            batch[j] = t * kNumValuesPerThread + i + j;
+          }
+          const size_t numPushed = shared.tryPushBatch(std::span(batch, n));
+          if (!numPushed) {
+            std::this_thread::yield();
+          }
+          i += static_cast<int>(numPushed);
+        }
+      }
+    });
+    threads.emplace_back([&]() {
+      while (numPopped.load() != kNumThreads * kNumValuesPerThread) {
+        int batch[3];
+        const size_t n = shared.tryPopBatch(batch);
+        if (!n) {
+          std::this_thread::yield();
+        }
+        for (size_t j = 0; j != n; j++) {
+          numReceived[batch[j]]++;
+        }
+        numPopped += static_cast<int>(n);
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  ASSERT_TRUE(std::all_of(numReceived.begin(), numReceived.end(), [](const std::atomic<int>& n) { return n == 1; }));
+  ASSERT_TRUE(shared.empty());
+}
+
+GTEST_TEST(lutils, ThreadPool) {
+  ldr::ThreadPool pool(3, true);
+  ldr::ThreadPool inlinePool(0);
+
+  ASSERT_EQ(pool.getNumThreads(), 4);
+  ASSERT_EQ(inlinePool.getNumThreads(), 1);
+
+  // every index is visited exactly once, chunks respect the grain size
+  constexpr size_t kNumItems = 100000;
+  std::vector<uint8_t> numVisits(kNumItems, 0);
+  std::atomic<bool> isGrainRespected = true;
+  ldr::parallelFor(
+      0,
+      kNumItems,
+      [&](size_t i0, size_t i1) {
+        if (i1 - i0 > 1000) {
+          isGrainRespected = false;
+        }
+        for (size_t i = i0; i != i1; i++) {
+          numVisits[i]++;
+        }
+      },
+      1000,
+      pool);
+  ASSERT_TRUE(isGrainRespected);
+  ASSERT_TRUE(std::all_of(numVisits.begin(), numVisits.end(), [](uint8_t n) { return n == 1; }));
+
+  // the reduction order does not depend on the scheduling
+  auto sumFloats = [](ldr::ThreadPool& p) {
+    return ldr::parallelReduce(
+        size_t(0),
+        kNumItems,
+        0.0f,
+        [](size_t i0, size_t i1) {
+          float sum = 0;
+          for (size_t i = i0; i != i1; i++) {
+            sum += 1.0f / float(i + 1);
+          }
+          return sum;
+        },
+        [](float a, float b) { return a + b; },
+        777,
+        p);
+  };
+  ASSERT_EQ(sumFloats(pool), sumFloats(inlinePool));
+  ASSERT_EQ(ldr::parallelReduce(size_t(5), size_t(5), 42, [](size_t, size_t) { return 0; }, [](int a, int b) { return a + b; }), 42);
+
+  // nested parallelism and recursive task groups
+  std::function<uint64_t(uint32_t)> fib = [&](uint32_t n) -> uint64_t {
+    if (n < 2) {
+      return n;
+    }
+    uint64_t a = 0;
+    ldr::TaskGroup group(pool);
+    group.run([&]() { a = fib(n - 1); });
+    const uint64_t b = fib(n - 2);
+    group.wait();
+    return a + b;
+  };
+  ASSERT_EQ(fib(18), 2584);
+
+  std::atomic<uint64_t> nestedSum = 0;
+  ldr::parallelFor(
+      0,
+      16,
+      [&](size_t i0, size_t i1) {
+        for (size_t i = i0; i != i1; i++) {
+          nestedSum += ldr::parallelReduce(
+              size_t(0), size_t(1000), uint64_t(0), [](size_t j0, size_t j1) { return uint64_t(j1 - j0); }, std::plus<uint64_t>(), 10, pool);
+        }
+      },
+      1,
+      pool);
+  ASSERT_EQ(nestedSum, 16000);
+
+  const ldr::ThreadPoolStats stats = pool.getStats();
+  ASSERT_GT(stats.numTasks, 0);
+  pool.resetStats();
+  ASSERT_EQ(pool.getStats().numTasks, 0);
+
+  // the default pool runs Array2D row bands
+  ldr::Array2D<std::vector<int>> array(100, 37);
+  std::atomic<size_t> numRows = 0;
+  ldr::parallelForRows(array, [&](size_t j0, size_t j1) { numRows += j1 - j0; }, 5);
+  ASSERT_EQ(numRows, 37);
+
+  // a slow task: the waiting thread runs out of work and blocks until it is done
+  std::atomic<bool> isSlowTaskDone = false;
+  {
+    ldr::TaskGroup group(pool);
+    group.run([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      isSlowTaskDone = true;
+    });
+    group.wait();
+  }
+  ASSERT_TRUE(isSlowTaskDone);
+
+  // exceptions do not stop the other tasks and are rethrown by wait()
+  for (ldr::ThreadPool* p : {&pool, &inlinePool}) {
+    std::atomic<size_t> numItems = 0;
+    EXPECT_THROW(ldr::parallelFor(
+                     0,
+                     100,
+                     [&](size_t i0, size_t i1) {
+                       numItems += i1 - i0;
+                       if (i1 == 100) {
+                         throw std::runtime_error("task failed");
+                       }
+                     },
+                     10,
+                     *p),
+                 std::runtime_error);
+    EXPECT_EQ(numItems, 100);
+    ldr::TaskGroup group(*p);
+    group.run([]() { throw 42; });
+    EXPECT_THROW(group.wait(), int);
+    EXPECT_NO_THROW(group.wait());
+  }
+}
+
+} // namespace ltests